@@ -0,0 +1,101 @@
+/** Evaluates a `BSpline` using cached parameters and the knot span of the previous evaluation, so that the parameters don't
+  * need to be recalculated for every call, and consecutive t values only need to check the current and next spans.
+  * This is most effective when stepping along the curve with monotonically increasing t values, but any t value is valid.
+  * `start` must be called again whenever the vertex count, degree, clamped, or closed properties change. */
+class BSplineCursor
+{
+	
+	/** The knot span used by the last evaluation, or -1 if nothing has been evaluated since `start`. */
+	int span = -1;
+	
+	private BSpline@ b_spline;
+	private int degree;
+	private bool clamped;
+	private bool closed;
+	private int v_count;
+	private int degree_c;
+	private float u_scale;
+	/** False if the curve is degenerate and must be evaluated by the regular `BSpline` methods. */
+	private bool direct;
+	
+	/** Caches the parameters for the given spline. Must be called after `BSpline.set_vertices` and `BSpline.generate_knots`. */
+	void start(BSpline@ b_spline, const int degree, const bool clamped, const bool closed)
+	{
+		@this.b_spline = b_spline;
+		this.degree = degree;
+		this.clamped = clamped;
+		this.closed = closed;
+		span = -1;
+		
+		direct = b_spline !is null && b_spline.init_span_params(degree, clamped, closed, v_count, degree_c, u_scale);
+	}
+	
+	/** Returns the point and normal at the given `t` value. */
+	void eval(const float t, float &out x, float &out y, float &out normal_x, float &out normal_y)
+	{
+		if(!direct)
+		{
+			b_spline.eval(degree, clamped, closed, t, x, y, normal_x, normal_y);
+			return;
+		}
+		
+		const float u = t * u_scale;
+		span = b_spline.find_span_from(degree_c, u, span);
+		b_spline.eval_span(degree_c, v_count, clamped, closed, span, u, x, y, normal_x, normal_y);
+	}
+	
+	/** Returns the point at the given `t` value. */
+	void eval_point(const float t, float &out x, float &out y)
+	{
+		if(!direct)
+		{
+			b_spline.eval_point(degree, clamped, closed, t, x, y);
+			return;
+		}
+		
+		const float u = t * u_scale;
+		span = b_spline.find_span_from(degree_c, u, span);
+		b_spline.eval_span_point(degree_c, v_count, clamped, closed, span, u, x, y);
+	}
+	
+	/** Returns the normal at the given `t` value. */
+	void eval_normal(const float t, float &out normal_x, float &out normal_y)
+	{
+		if(!direct)
+		{
+			b_spline.eval_normal(degree, clamped, closed, t, normal_x, normal_y);
+			return;
+		}
+		
+		float dx, dy;
+		eval_derivative(t, dx, dy);
+		normal_x = dy;
+		normal_y = -dx;
+		
+		const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+		if(length != 0)
+		{
+			normal_x /= length;
+			normal_y /= length;
+		}
+	}
+	
+	/** Returns the first derivative with respect to `t` at the given `t` value. */
+	void eval_derivative(const float t, float &out dx, float &out dy)
+	{
+		if(!direct)
+		{
+			b_spline.eval_derivative(degree, clamped, closed, t, dx, dy);
+			return;
+		}
+		
+		const float u = t * u_scale;
+		span = b_spline.find_span_from(degree_c, u, span);
+		b_spline.eval_span_derivative(degree_c, v_count, clamped, closed, span, u, dx, dy);
+		
+		// Scale from knot space back to t.
+		dx *= u_scale;
+		dy *= u_scale;
+	}
+	
+}
@@ -0,0 +1,376 @@
+/** A uniform grid over the arcs calculated by `Curve::calculate_arc_lengths`, allowing `Curve::closest_point` to only test the arcs near a point
+  * instead of every arc of the curve.
+  * Each cell stores a linked list of the arcs whose chord overlaps it, referenced by segment and arc index so that they stay valid when the
+  * arcs are moved or compacted. Arcs are never removed individually. Instead each segment has a generation which is incremented when it is
+  * updated, making its previous entries stale, and the grid is rebuilt once there are more stale entries than live ones, or the curve grows
+  * outside of the grid. */
+class CurveArcGrid
+{
+	
+	/** Limits the number of cells for very large or sparse curves. Cells will be made larger as needed. */
+	int max_cells = 65536;
+	
+	/** The width and height of each cell. */
+	float cell_size;
+	
+	/** The number of cells in each direction. */
+	int cols, rows;
+	
+	/** The segments with at least one candidate arc found by the last `query`, in ascending order. */
+	array<int> candidate_segments;
+	int candidate_count;
+	
+	/** The bounds of the grid. Padded when rebuilt so that small changes to the curve don't require a rebuild. */
+	private float x1, y1, x2, y2;
+	private int segment_count;
+	
+	private array<int> cell_head;
+	private array<int> entry_next;
+	private array<int> entry_segment;
+	private array<int> entry_arc;
+	private array<int> entry_generation;
+	private int entry_count;
+	private int stale_count;
+	
+	private array<int> segment_generation;
+	private array<int> segment_entry_count;
+	
+	/** Marks the arcs and segments already visited by the current query. */
+	private array<int> arc_stamp;
+	private array<int> segment_stamp;
+	private int stamp;
+	/** The squared distance to the closest arc found so far by the current query. */
+	private float query_best;
+	
+	/** Removes all arcs. */
+	void clear()
+	{
+		cols = 0;
+		rows = 0;
+		segment_count = 0;
+		entry_count = 0;
+		stale_count = 0;
+		candidate_count = 0;
+	}
+	
+	/** Inserts the arcs of any invalidated segments, or rebuilds the grid if `rebuild` is true, the number of segments has changed, or an
+	  * invalidated segment no longer fits within the grid.
+	  * @param vertices The vertices of the curve. Each must have valid arcs.
+	  * @param segment_count The number of segments.
+	  * @param arcs The arcs calculated by `calculate_arc_lengths`.
+	  * @param cell_size The size of each cell. If <= 0 it is based on the average length of the arcs. */
+	void update(
+		array<CurveVertex>@ vertices, const int segment_count, CurveArcs@ arcs,
+		const float cell_size, bool rebuild)
+	{
+		rebuild = rebuild || cols == 0 || this.segment_count != segment_count || stale_count > entry_count - stale_count;
+		
+		if(!rebuild)
+		{
+			for(int i = 0; i < segment_count; i++)
+			{
+				CurveVertex@ v = vertices[i];
+				if(v.invalidated && !contains_arcs(v, arcs))
+				{
+					rebuild = true;
+					break;
+				}
+			}
+		}
+		
+		if(rebuild)
+		{
+			build(vertices, segment_count, arcs, cell_size);
+			return;
+		}
+		
+		for(int i = 0; i < segment_count; i++)
+		{
+			if(!vertices[i].invalidated)
+				continue;
+			
+			stale_count += segment_entry_count[i];
+			segment_entry_count[i] = 0;
+			segment_generation[i]++;
+			insert_segment(vertices[i], i, arcs);
+		}
+	}
+	
+	/** Finds the arcs near the given point by searching the cells in rings of increasing size around it, stopping once the nearest side of
+	  * a ring is farther away than the closest arc found so far.
+	  * The segments of the found arcs are stored in `candidate_segments`, and `is_candidate` can be used to check individual arcs.
+	  * @param max_distance If > 0, cells farther away than this are not searched.
+	  * @return The number of candidate segments. */
+	int query(
+		array<CurveVertex>@ vertices, CurveArcs@ arcs,
+		const float x, const float y, const float max_distance=0)
+	{
+		candidate_count = 0;
+		
+		if(cols == 0)
+			return 0;
+		
+		stamp++;
+		if(int(arc_stamp.length) < arcs.size)
+		{
+			arc_stamp.resize(arcs.size);
+		}
+		if(int(segment_stamp.length) < segment_count)
+		{
+			segment_stamp.resize(segment_count);
+		}
+		if(int(candidate_segments.length) < segment_count)
+		{
+			candidate_segments.resize(segment_count);
+		}
+		
+		const int cx = int(floor((x - x1) / cell_size));
+		const int cy = int(floor((y - y1) / cell_size));
+		query_best = INFINITY;
+		
+		// Skip the rings that don't overlap the grid when the point is outside of it.
+		const int r_start = max(max(max(-cx, cx - cols + 1), max(-cy, cy - rows + 1)), 0);
+		
+		for(int r = r_start; ; r++)
+		{
+			// The closest any cell in this ring can be, assuming the point could be anywhere within its own cell.
+			const float ring_distance = max(r - 1, 0) * cell_size;
+			if(ring_distance * ring_distance > query_best)
+				break;
+			if(max_distance > 0 && ring_distance > max_distance)
+				break;
+			// The previous ring already covered every cell in the grid.
+			if(r > 0 && cx - r + 1 <= 0 && cy - r + 1 <= 0 && cx + r - 1 >= cols - 1 && cy + r - 1 >= rows - 1)
+				break;
+			
+			const int col1 = max(cx - r, 0);
+			const int col2 = min(cx + r, cols - 1);
+			const int row1 = max(cy - r, 0);
+			const int row2 = min(cy + r, rows - 1);
+			
+			for(int row = row1; row <= row2; row++)
+			{
+				// Only the first and last rows of the ring are full rows, otherwise just the cells at either end.
+				if(r == 0 || row == cy - r || row == cy + r)
+				{
+					for(int col = col1; col <= col2; col++)
+					{
+						visit_cell(row * cols + col, vertices, arcs, x, y);
+					}
+				}
+				else
+				{
+					if(cx - r >= 0)
+					{
+						visit_cell(row * cols + cx - r, vertices, arcs, x, y);
+					}
+					if(cx + r < cols)
+					{
+						visit_cell(row * cols + cx + r, vertices, arcs, x, y);
+					}
+				}
+			}
+		}
+		
+		if(candidate_count > 1)
+		{
+			candidate_segments.sortAsc(0, candidate_count);
+		}
+		
+		return candidate_count;
+	}
+	
+	/** Returns true if the arc at the given index in `CurveArcs` was found by the last `query`. */
+	bool is_candidate(const int arc_index) const
+	{
+		return arc_index < int(arc_stamp.length) && arc_stamp[arc_index] == stamp;
+	}
+	
+	/** Adds the live arcs in the given cell to the candidates. */
+	private void visit_cell(const int cell, array<CurveVertex>@ vertices, CurveArcs@ arcs, const float x, const float y)
+	{
+		for(int e = cell_head[cell]; e != -1; e = entry_next[e])
+		{
+			const int segment = entry_segment[e];
+			if(entry_generation[e] != segment_generation[segment])
+				continue;
+			
+			CurveVertex@ v = vertices[segment];
+			const int j = entry_arc[e];
+			if(j >= v.arc_count)
+				continue;
+			
+			const int k = v.arc_offset + j;
+			if(arc_stamp[k] == stamp)
+				continue;
+			
+			arc_stamp[k] = stamp;
+			
+			if(segment_stamp[segment] != stamp)
+			{
+				segment_stamp[segment] = stamp;
+				candidate_segments[candidate_count++] = segment;
+			}
+			
+			const float dx = arcs.x[k] - x;
+			const float dy = arcs.y[k] - y;
+			const float dist = dx * dx + dy * dy;
+			if(dist < query_best)
+			{
+				query_best = dist;
+			}
+		}
+	}
+	
+	private void build(array<CurveVertex>@ vertices, const int segment_count, CurveArcs@ arcs, float cell_size)
+	{
+		this.segment_count = segment_count;
+		entry_count = 0;
+		stale_count = 0;
+		
+		// -- Find the bounds and average arc length.
+		
+		const array<float>@ arc_x = @arcs.x;
+		const array<float>@ arc_y = @arcs.y;
+		const array<float>@ arc_length = @arcs.length;
+		
+		x1 = INFINITY;
+		y1 = INFINITY;
+		x2 = -INFINITY;
+		y2 = -INFINITY;
+		float total_length = 0;
+		int arc_count = 0;
+		
+		for(int i = 0; i < segment_count; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			const int end = v.arc_offset + v.arc_count;
+			for(int k = v.arc_offset; k < end; k++)
+			{
+				const float x = arc_x[k];
+				const float y = arc_y[k];
+				if(x < x1) x1 = x;
+				if(y < y1) y1 = y;
+				if(x > x2) x2 = x;
+				if(y > y2) y2 = y;
+				total_length += arc_length[k];
+			}
+			
+			arc_count += v.arc_count;
+		}
+		
+		if(arc_count == 0)
+		{
+			clear();
+			return;
+		}
+		
+		if(cell_size <= 0)
+		{
+			cell_size = total_length / arc_count * 2;
+		}
+		
+		// Pad the bounds by a few cells and a fraction of the size, and limit the number of cells for very large or sparse curves.
+		const float pad = max(cell_size * 2, max(x2 - x1, y2 - y1) * 0.1);
+		x1 -= pad;
+		y1 -= pad;
+		x2 += pad;
+		y2 += pad;
+		
+		cell_size = max(cell_size, sqrt((x2 - x1) * (y2 - y1) / max_cells));
+		if(cell_size <= 0)
+		{
+			cell_size = 1;
+		}
+		
+		this.cell_size = cell_size;
+		cols = int(ceil((x2 - x1) / cell_size)) + 1;
+		rows = int(ceil((y2 - y1) / cell_size)) + 1;
+		
+		const int cell_count = cols * rows;
+		if(int(cell_head.length) < cell_count)
+		{
+			cell_head.resize(cell_count);
+		}
+		for(int i = 0; i < cell_count; i++)
+		{
+			cell_head[i] = -1;
+		}
+		
+		if(int(segment_generation.length) < segment_count)
+		{
+			segment_generation.resize(segment_count);
+			segment_entry_count.resize(segment_count);
+		}
+		
+		for(int i = 0; i < segment_count; i++)
+		{
+			segment_generation[i]++;
+			segment_entry_count[i] = 0;
+			insert_segment(vertices[i], i, arcs);
+		}
+	}
+	
+	private bool contains_arcs(CurveVertex@ v, CurveArcs@ arcs)
+	{
+		const array<float>@ arc_x = @arcs.x;
+		const array<float>@ arc_y = @arcs.y;
+		
+		const int end = v.arc_offset + v.arc_count;
+		for(int k = v.arc_offset; k < end; k++)
+		{
+			if(arc_x[k] < x1 || arc_x[k] > x2 || arc_y[k] < y1 || arc_y[k] > y2)
+				return false;
+		}
+		
+		return true;
+	}
+	
+	/** Inserts every arc of the segment into the cells overlapped by the bounding box of its chord. */
+	private void insert_segment(CurveVertex@ v, const int segment, CurveArcs@ arcs)
+	{
+		const array<float>@ arc_x = @arcs.x;
+		const array<float>@ arc_y = @arcs.y;
+		
+		for(int j = 0; j < v.arc_count; j++)
+		{
+			const int k = v.arc_offset + j;
+			const int k0 = j > 0 ? k - 1 : k;
+			
+			const int col1 = clamp(int((min(arc_x[k0], arc_x[k]) - x1) / cell_size), 0, cols - 1);
+			const int col2 = clamp(int((max(arc_x[k0], arc_x[k]) - x1) / cell_size), 0, cols - 1);
+			const int row1 = clamp(int((min(arc_y[k0], arc_y[k]) - y1) / cell_size), 0, rows - 1);
+			const int row2 = clamp(int((max(arc_y[k0], arc_y[k]) - y1) / cell_size), 0, rows - 1);
+			
+			for(int row = row1; row <= row2; row++)
+			{
+				for(int col = col1; col <= col2; col++)
+				{
+					add_entry(row * cols + col, segment, j);
+				}
+			}
+		}
+	}
+	
+	private void add_entry(const int cell, const int segment, const int arc)
+	{
+		if(entry_count >= int(entry_next.length))
+		{
+			const int size = max(entry_count * 2, 64);
+			entry_next.resize(size);
+			entry_segment.resize(size);
+			entry_arc.resize(size);
+			entry_generation.resize(size);
+		}
+		
+		entry_next[entry_count] = cell_head[cell];
+		entry_segment[entry_count] = segment;
+		entry_arc[entry_count] = arc;
+		entry_generation[entry_count] = segment_generation[segment];
+		cell_head[cell] = entry_count;
+		
+		entry_count++;
+		segment_entry_count[segment]++;
+	}
+	
+}
@@ -0,0 +1,202 @@
+/** A packed, curve wide store of the arcs calculated by `Curve::calculate_arc_lengths`.
+  * Each property is stored in its own array, and each vertex/segment references a contiguous range using `arc_offset` and `arc_count`.
+  * When a segment is recalculated with more arcs than it previously had, it is moved to the end of the store, and the store is compacted
+  * once enough entries are no longer referenced. */
+class CurveArcs
+{
+	
+	/** The t value of each arc relative to its segment. */
+	array<float> t(64);
+	/** The position of each arc. */
+	array<float> x(64);
+	array<float> y(64);
+	/** The delta from the previous arc to this one. */
+	array<float> dx(64);
+	array<float> dy(64);
+	/** The normalised delta/direction of each arc segment. */
+	array<float> nx(64);
+	array<float> ny(64);
+	/** The squared length of each arc segment. */
+	array<float> length_sqr(64);
+	/** The length of each arc segment. */
+	array<float> length(64);
+	/** The total length from the start of the segment to the end of each arc. */
+	array<float> total_length(64);
+	/** The difference in the t value from the start of each arc segment to the end. */
+	array<float> t_length(64);
+	
+	/** The number of used entries, including ones that are no longer referenced by any segment. */
+	int size;
+	
+	private int capacity = 64;
+	private array<float> scratch(64);
+	
+	/** Removes all arcs. Any vertices referencing this store must also be reset. */
+	void clear()
+	{
+		size = 0;
+	}
+	
+	/** Makes sure there is room for at least `count` more entries without resizing. */
+	void reserve(const int count)
+	{
+		if(size + count <= capacity)
+			return;
+		
+		while(capacity < size + count)
+		{
+			capacity *= 2;
+		}
+		
+		t.resize(capacity);
+		x.resize(capacity);
+		y.resize(capacity);
+		dx.resize(capacity);
+		dy.resize(capacity);
+		nx.resize(capacity);
+		ny.resize(capacity);
+		length_sqr.resize(capacity);
+		length.resize(capacity);
+		total_length.resize(capacity);
+		t_length.resize(capacity);
+	}
+	
+	/** Appends an arc to the end of the store.
+	  * @return The index of the new arc. */
+	int add(
+		const float t, const float x, const float y,
+		const float dx, const float dy, const float nx, const float ny,
+		const float length_sqr, const float length, const float total_length, const float t_length)
+	{
+		if(size >= capacity)
+		{
+			reserve(1);
+		}
+		
+		this.t[size] = t;
+		this.x[size] = x;
+		this.y[size] = y;
+		this.dx[size] = dx;
+		this.dy[size] = dy;
+		this.nx[size] = nx;
+		this.ny[size] = ny;
+		this.length_sqr[size] = length_sqr;
+		this.length[size] = length;
+		this.total_length[size] = total_length;
+		this.t_length[size] = t_length;
+		
+		return size++;
+	}
+	
+	/** Assigns all arcs added since `start` to the given vertex/segment.
+	  * If they fit within the range previously used by the segment, they are copied there and the end of the store is released. */
+	void commit(CurveVertex@ v, const int start)
+	{
+		const int count = size - start;
+		
+		if(count <= v.arc_capacity)
+		{
+			copy(start, v.arc_offset, count);
+			size = start;
+		}
+		else
+		{
+			v.arc_offset = start;
+			v.arc_capacity = count;
+		}
+		
+		v.arc_count = count;
+	}
+	
+	/** Packs the arcs of all segments into a single contiguous range if enough of the store is no longer referenced.
+	  * @param segment_count The number of vertices that represent a segment. Any vertices after that will have their arcs reset. */
+	void compact(array<CurveVertex>@ vertices, const int vertex_count, const int segment_count)
+	{
+		int used = 0;
+		for(int i = 0; i < segment_count; i++)
+		{
+			used += vertices[i].arc_count;
+		}
+		
+		if(size <= used * 2 + 64)
+			return;
+		
+		if(int(scratch.length) < used)
+		{
+			scratch.resize(capacity);
+		}
+		
+		compact_field(t, vertices, segment_count);
+		compact_field(x, vertices, segment_count);
+		compact_field(y, vertices, segment_count);
+		compact_field(dx, vertices, segment_count);
+		compact_field(dy, vertices, segment_count);
+		compact_field(nx, vertices, segment_count);
+		compact_field(ny, vertices, segment_count);
+		compact_field(length_sqr, vertices, segment_count);
+		compact_field(length, vertices, segment_count);
+		compact_field(total_length, vertices, segment_count);
+		compact_field(t_length, vertices, segment_count);
+		
+		int offset = 0;
+		for(int i = 0; i < segment_count; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			v.arc_offset = offset;
+			v.arc_capacity = v.arc_count;
+			offset += v.arc_count;
+		}
+		
+		for(int i = segment_count < 0 ? 0 : segment_count; i < vertex_count; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			v.arc_offset = 0;
+			v.arc_count = 0;
+			v.arc_capacity = 0;
+		}
+		
+		size = used;
+	}
+	
+	private void copy(const int from, const int to, const int count)
+	{
+		if(from == to)
+			return;
+		
+		for(int i = 0; i < count; i++)
+		{
+			const int src = from + i;
+			const int dst = to + i;
+			t[dst] = t[src];
+			x[dst] = x[src];
+			y[dst] = y[src];
+			dx[dst] = dx[src];
+			dy[dst] = dy[src];
+			nx[dst] = nx[src];
+			ny[dst] = ny[src];
+			length_sqr[dst] = length_sqr[src];
+			length[dst] = length[src];
+			total_length[dst] = total_length[src];
+			t_length[dst] = t_length[src];
+		}
+	}
+	
+	private void compact_field(array<float>@ field, array<CurveVertex>@ vertices, const int segment_count)
+	{
+		int offset = 0;
+		for(int i = 0; i < segment_count; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			for(int j = 0; j < v.arc_count; j++)
+			{
+				scratch[offset++] = field[v.arc_offset + j];
+			}
+		}
+		
+		for(int i = 0; i < offset; i++)
+		{
+			field[i] = scratch[i];
+		}
+	}
+	
+}
@@ -0,0 +1,37 @@
+/** Stores the result of a `MultiCurve::closest_point_warm` call, so that the next call can start searching from the previous closest point
+  * instead of the whole curve, and skip the search entirely if neither the point nor the curve has changed.
+  * Each query that should be tracked separately, e.g. each mouse cursor, needs its own instance. */
+class CurveClosestPoint
+{
+	
+	/** True if the last query found a point. */
+	bool found;
+	
+	/** The point passed to the last query. */
+	float x, y;
+	
+	/** The closest point found by the last query. */
+	int segment = -1;
+	float t;
+	float px, py;
+	
+	/** The `MultiCurve.version` at the time of the last query, or -1 if nothing has been queried since the last `reset`. */
+	int version = -1;
+	
+	/** The settings passed to the last query. The cached result is only reused if these are also unchanged. */
+	float max_distance;
+	float threshold;
+	bool arc_length_interpolation;
+	bool adjust_initial_binary_factor;
+	bool interpolate_result;
+	bool newton;
+	
+	/** Forces the next query to search the whole curve. */
+	void reset()
+	{
+		found = false;
+		segment = -1;
+		version = -1;
+	}
+	
+}
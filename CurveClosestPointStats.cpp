@@ -0,0 +1,23 @@
+/** The amount of work done by `Curve::closest_point`, e.g. to compare the refinement modes. */
+class CurveClosestPointStats
+{
+	
+	/** The number of refinement steps. */
+	int iterations;
+	
+	/** The number of times the curve was evaluated. */
+	int evals;
+	
+	void reset()
+	{
+		iterations = 0;
+		evals = 0;
+	}
+	
+	void add(const int iterations, const int evals)
+	{
+		this.iterations += iterations;
+		this.evals += evals;
+	}
+	
+}
@@ -0,0 +1,50 @@
+/** Scratch arrays used by `Curve::closest_points`, so that they don't need to be allocated for every call.
+  * Each array only grows, and is resized when a call needs more entries than it has. */
+class CurveClosestPointsScratch
+{
+	
+	/** The segment and point index of each candidate segment/point pair. */
+	array<int> pair_segment;
+	array<int> pair_query;
+	
+	/** The start of each segment's range in `bucket_query`. */
+	array<int> bucket_start;
+	/** The point indices of every pair, grouped by segment. */
+	array<int> bucket_query;
+	
+	/** The closest candidate found so far for each point. */
+	array<float> best_dist;
+	array<int> best_segment;
+	array<int> best_arc;
+	array<bool> best_exact;
+	array<float> best_t;
+	array<float> best_x;
+	array<float> best_y;
+	
+	/** Makes sure the per point arrays have at least `count` entries, and `bucket_start` at least `segment_count + 1`. */
+	void reserve(const int count, const int segment_count)
+	{
+		if(int(pair_segment.length) < count)
+		{
+			pair_segment.resize(count);
+			pair_query.resize(count);
+		}
+		
+		if(int(best_dist.length) < count)
+		{
+			best_dist.resize(count);
+			best_segment.resize(count);
+			best_arc.resize(count);
+			best_exact.resize(count);
+			best_t.resize(count);
+			best_x.resize(count);
+			best_y.resize(count);
+		}
+		
+		if(int(bucket_start.length) < segment_count + 1)
+		{
+			bucket_start.resize(segment_count + 1);
+		}
+	}
+	
+}
@@ -0,0 +1,191 @@
+/** Stores a Chebyshev polynomial approximation of the inverse arc length of each segment of a curve, i.e. the t value at a given distance
+  * from the start of the segment. Allows converting a distance to a t value in constant time without searching the arcs or evaluating the curve.
+  * Each segment is fitted from the arcs calculated by `Curve::calculate_arc_lengths`, and checked against them, and segments which can not
+  * be fitted within the given tolerance are flagged so that callers can fall back to the arcs. */
+class CurveDistanceFit
+{
+	
+	/** The number of coefficients per segment. */
+	int order;
+	
+	/** The tolerance the segments were fitted with. */
+	float tolerance;
+	
+	/** The number of segments. */
+	int count;
+	
+	/** The largest error in world units of any segment that was fitted within the tolerance. */
+	float max_error;
+	
+	/** The number of segments that could not be fitted within the tolerance. */
+	int failed_count;
+	
+	private array<float> coefficients;
+	private array<float> lengths;
+	private array<float> errors;
+	private array<bool> valid;
+	private array<float> samples;
+	
+	/** Removes all fitted segments. */
+	void clear()
+	{
+		count = 0;
+		max_error = 0;
+		failed_count = 0;
+	}
+	
+	/** Fits any invalidated segments, or all segments if `rebuild` is true or the number of segments, order, or tolerance has changed.
+	  * @param vertices The vertices of the curve. Each must have valid arcs and `length`.
+	  * @param segment_count The number of segments.
+	  * @param arcs The arcs calculated by `calculate_arc_lengths`.
+	  * @param order The number of coefficients per segment. Higher orders can fit longer and more complex segments at the cost of memory and
+	  *   evaluation time.
+	  * @param tolerance The maximum distance in world units along the curve that the fitted t value may be from the arcs.
+	  * @param rebuild Forces every segment to be fitted, e.g. after vertices have been added or removed. */
+	void update(
+		array<CurveVertex>@ vertices, const int segment_count, CurveArcs@ arcs,
+		const int order, const float tolerance, const bool rebuild)
+	{
+		const bool fit_all = rebuild || this.order != order || this.tolerance != tolerance || count != segment_count;
+		
+		this.order = order;
+		this.tolerance = tolerance;
+		count = segment_count > 0 ? segment_count : 0;
+		
+		if(int(valid.length) < count)
+		{
+			valid.resize(count);
+			lengths.resize(count);
+			errors.resize(count);
+		}
+		if(int(coefficients.length) < count * order)
+		{
+			coefficients.resize(count * order);
+		}
+		if(int(samples.length) < order)
+		{
+			samples.resize(order);
+		}
+		
+		max_error = 0;
+		failed_count = 0;
+		
+		for(int i = 0; i < count; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			
+			if(fit_all || v.invalidated)
+			{
+				fit(i, v, arcs, tolerance);
+			}
+			
+			if(!valid[i])
+			{
+				failed_count++;
+			}
+			else if(errors[i] > max_error)
+			{
+				max_error = errors[i];
+			}
+		}
+	}
+	
+	/** Finds the t value at the given distance from the start of a segment.
+	  * @param segment The segment index.
+	  * @param distance The distance from the start of the segment.
+	  * @param t Receives the t value within the segment.
+	  * @return False if the segment does not have a valid fit, in which case `t` is not set and the arcs should be used instead. */
+	bool eval(const int segment, const float distance, float &out t) const
+	{
+		if(segment < 0 || segment >= count || !valid[segment])
+			return false;
+		
+		const float length = lengths[segment];
+		const float x = clamp(distance / length * 2 - 1, -1.0, 1.0);
+		t = clamp01(clenshaw(segment * order, x));
+		return true;
+	}
+	
+	/** Fits a single segment by sampling the arcs at the Chebyshev nodes, and then measures the error at the end and middle of each arc. */
+	private void fit(const int segment, CurveVertex@ v, CurveArcs@ arcs, const float tolerance)
+	{
+		const float length = v.length;
+		lengths[segment] = length;
+		errors[segment] = 0;
+		valid[segment] = false;
+		
+		if(order <= 0 || v.arc_count < 2 || length <= 0 || is_nan(length))
+			return;
+		
+		// Sample t at the Chebyshev nodes.
+		for(int k = 0; k < order; k++)
+		{
+			const float x = cos(PI * (k + 0.5) / order);
+			samples[k] = Curve::segment_distance_to_t(arcs, v, (x + 1) * 0.5 * length);
+		}
+		
+		// Calculate the coefficients.
+		const int offset = segment * order;
+		for(int j = 0; j < order; j++)
+		{
+			float sum = 0;
+			for(int k = 0; k < order; k++)
+			{
+				sum += samples[k] * cos(PI * j * (k + 0.5) / order);
+			}
+			
+			coefficients[offset + j] = (j == 0 ? 1.0 : 2.0) * sum / order;
+		}
+		
+		// The arc end points lie on the real curve, so convert the difference in t at each of them to a distance using
+		// the average speed of the adjacent arc.
+		// The fit is closest to exact near the end points, so also check the middle of each arc against the linearly interpolated t value
+		// that `segment_distance_to_t` would return, to catch the fit oscillating between them.
+		float error = 0;
+		for(int j = 0; j < v.arc_count; j++)
+		{
+			const int k = v.arc_offset + j;
+			const int ks = j > 0 ? k : k + 1;
+			if(arcs.t_length[ks] == 0)
+				continue;
+			
+			const float speed = arcs.length[ks] / arcs.t_length[ks];
+			
+			const float x = clamp(arcs.total_length[k] / length * 2 - 1, -1.0, 1.0);
+			float arc_error = abs(clenshaw(offset, x) - arcs.t[k]) * speed;
+			
+			if(j > 0)
+			{
+				const float xm = clamp((arcs.total_length[k] - arcs.length[k] * 0.5) / length * 2 - 1, -1.0, 1.0);
+				const float tm = (arcs.t[k - 1] + arcs.t[k]) * 0.5;
+				arc_error = max(arc_error, abs(clenshaw(offset, xm) - tm) * speed);
+			}
+			
+			if(arc_error > error)
+			{
+				error = arc_error;
+			}
+		}
+		
+		errors[segment] = error;
+		valid[segment] = error <= tolerance && !is_nan(error);
+	}
+	
+	/** Evaluates the Chebyshev series starting at `offset` using Clenshaw's recurrence. */
+	private float clenshaw(const int offset, const float x) const
+	{
+		const float x2 = x * 2;
+		float b1 = 0;
+		float b2 = 0;
+		
+		for(int j = order - 1; j >= 1; j--)
+		{
+			const float b = x2 * b1 - b2 + coefficients[offset + j];
+			b2 = b1;
+			b1 = b;
+		}
+		
+		return x * b1 - b2 + coefficients[offset];
+	}
+	
+}
@@ -0,0 +1,240 @@
+#include 'EvalFunc.cpp';
+
+/** Evaluates a curve at the given segment index and t value. Used by the arc length and closest point routines instead of the `Curve::Eval*Func`
+  * delegates, so that the curve type only needs to be resolved once when the kernel is selected, instead of for every sample.
+  * The segment and t value have the same meaning as the `Curve::Eval*Func` parameters. */
+interface CurveKernel
+{
+	
+	void eval(const int segment, const float t, float &out x, float &out y, float &out normal_x, float &out normal_y);
+	
+	void eval_point(const int segment, const float t, float &out x, float &out y);
+	
+	/** Returns the first derivative with respect to the segment's t value. */
+	void eval_derivative(const int segment, const float t, float &out dx, float &out dy);
+	
+	/** Returns the point, and the first and second derivatives with respect to the segment's t value.
+	  * @return False if the kernel can't calculate derivatives, in which case the outputs are undefined. */
+	bool eval_derivatives(
+		const int segment, const float t, float &out x, float &out y,
+		float &out dx, float &out dy, float &out ddx, float &out ddy);
+	
+	/** Finds the exact closest point on the given segment, if the segment has a closed form solution.
+	  * @return False if the point must instead be found by searching, in which case the outputs are undefined. */
+	bool closest_point(const int segment, const float x, const float y, float &out t, float &out px, float &out py);
+	
+}
+
+/** Evaluates a curve through the resolved `CurveSegment`s built when the curve is validated.
+  * Every segment must have a cached form, i.e. none can be `GenericSegment`. */
+class CurveSegmentKernel : CurveKernel
+{
+	
+	private array<CurveSegment>@ segments;
+	private int count;
+	
+	void init(array<CurveSegment>@ segments, const int count)
+	{
+		@this.segments = segments;
+		this.count = count;
+	}
+	
+	void eval(const int segment, const float t, float &out x, float &out y, float &out normal_x, float &out normal_y)
+	{
+		int i;
+		float ti;
+		resolve(segment, t, i, ti);
+		segments[i].eval(ti, x, y, normal_x, normal_y);
+	}
+	
+	void eval_point(const int segment, const float t, float &out x, float &out y)
+	{
+		int i;
+		float ti;
+		resolve(segment, t, i, ti);
+		segments[i].eval_point(ti, x, y);
+	}
+	
+	void eval_derivative(const int segment, const float t, float &out dx, float &out dy)
+	{
+		int i;
+		float ti;
+		resolve(segment, t, i, ti);
+		segments[i].eval_derivative(ti, dx, dy);
+	}
+	
+	bool eval_derivatives(
+		const int segment, const float t, float &out x, float &out y,
+		float &out dx, float &out dy, float &out ddx, float &out ddy)
+	{
+		int i;
+		float ti;
+		resolve(segment, t, i, ti);
+		segments[i].eval_derivatives(ti, x, y, dx, dy, ddx, ddy);
+		return true;
+	}
+	
+	/** Only linear and non-rational quadratic segments have a closed form solution. */
+	bool closest_point(const int segment, const float x, const float y, float &out t, float &out px, float &out py)
+	{
+		if(segment < 0 || segment >= count)
+			return false;
+		
+		return segments[segment].closest_point(x, y, t, px, py);
+	}
+	
+	/** Same as `MultiCurve::calc_segment_t`. */
+	private void resolve(const int segment, const float t, int &out i, float &out ti)
+	{
+		const int max_i = count - 1;
+		
+		if(segment < 0)
+		{
+			const float tt = t * count;
+			i = int(tt);
+			i = i <= max_i ? i : max_i;
+			ti = i <= max_i ? tt % 1 : 1;
+		}
+		else if(segment > max_i)
+		{
+			i = max_i;
+			ti = 1;
+		}
+		else
+		{
+			i = segment;
+			ti = t < 1 ? t : t > 0 ? t : 0;
+		}
+	}
+	
+}
+
+/** Evaluates a b-spline through a `BSplineCursor`, converting each segment's t value into the t value of the whole spline. */
+class BSplineKernel : CurveKernel
+{
+	
+	private BSplineCursor@ cursor;
+	private int segment_count;
+	
+	/** @param segment_count The number of curve segments the spline spans, i.e. the number of vertices when closed, or one less when open. */
+	void init(BSplineCursor@ cursor, const int segment_count)
+	{
+		@this.cursor = cursor;
+		this.segment_count = segment_count;
+	}
+	
+	void eval(const int segment, const float t, float &out x, float &out y, float &out normal_x, float &out normal_y)
+	{
+		cursor.eval(spline_t(segment, t), x, y, normal_x, normal_y);
+	}
+	
+	void eval_point(const int segment, const float t, float &out x, float &out y)
+	{
+		cursor.eval_point(spline_t(segment, t), x, y);
+	}
+	
+	void eval_derivative(const int segment, const float t, float &out dx, float &out dy)
+	{
+		cursor.eval_derivative(spline_t(segment, t), dx, dy);
+		
+		// The b-spline t value spans the entire curve, so scale it back to a single segment.
+		dx /= segment_count;
+		dy /= segment_count;
+	}
+	
+	/** The second derivative is approximated from the first. */
+	bool eval_derivatives(
+		const int segment, const float t, float &out x, float &out y,
+		float &out dx, float &out dy, float &out ddx, float &out ddy)
+	{
+		Curve::_eval_derivatives_central(this, segment, t, x, y, dx, dy, ddx, ddy);
+		return true;
+	}
+	
+	bool closest_point(const int segment, const float x, const float y, float &out t, float &out px, float &out py)
+	{
+		return false;
+	}
+	
+	private float spline_t(const int segment, const float t)
+	{
+		return segment >= 0 ? (segment + clamp01(t)) / segment_count : t;
+	}
+	
+}
+
+/** Evaluates a curve through the `Curve::Eval*Func` delegates, for curves without a specialised kernel.
+  * Functions that won't be used by the routine the kernel is passed to can be null. */
+class CurveFuncKernel : CurveKernel
+{
+	
+	Curve::EvalFunc@ eval_func;
+	Curve::EvalPointFunc@ eval_point_func;
+	Curve::EvalDerivativeFunc@ eval_derivative_func;
+	
+	CurveFuncKernel(Curve::EvalFunc@ eval_func, Curve::EvalPointFunc@ eval_point_func, Curve::EvalDerivativeFunc@ eval_derivative_func)
+	{
+		@this.eval_func = eval_func;
+		@this.eval_point_func = eval_point_func;
+		@this.eval_derivative_func = eval_derivative_func;
+	}
+	
+	void eval(const int segment, const float t, float &out x, float &out y, float &out normal_x, float &out normal_y)
+	{
+		eval_func(segment, t, x, y, normal_x, normal_y);
+	}
+	
+	void eval_point(const int segment, const float t, float &out x, float &out y)
+	{
+		eval_point_func(segment, t, x, y);
+	}
+	
+	void eval_derivative(const int segment, const float t, float &out dx, float &out dy)
+	{
+		eval_derivative_func(segment, t, dx, dy);
+	}
+	
+	/** The second derivative is approximated from the first. Requires both `eval_point_func` and `eval_derivative_func`. */
+	bool eval_derivatives(
+		const int segment, const float t, float &out x, float &out y,
+		float &out dx, float &out dy, float &out ddx, float &out ddy)
+	{
+		if(eval_point_func is null || eval_derivative_func is null)
+			return false;
+		
+		Curve::_eval_derivatives_central(this, segment, t, x, y, dx, dy, ddx, ddy);
+		return true;
+	}
+	
+	bool closest_point(const int segment, const float x, const float y, float &out t, float &out px, float &out py)
+	{
+		return false;
+	}
+	
+}
+
+namespace Curve
+{
+	
+	/** Internal method - evaluates the point and first derivative, and approximates the second derivative with a central difference of
+	  * the first. The difference is taken on one side only at the ends of the segment, since the kernel clamps t values outside of it. */
+	void _eval_derivatives_central(
+		CurveKernel@ kernel, const int segment, const float t, float &out x, float &out y,
+		float &out dx, float &out dy, float &out ddx, float &out ddy)
+	{
+		const float h = 0.001;
+		const float ta = max(t - h, 0.0);
+		const float tb = min(t + h, 1.0);
+		
+		kernel.eval_point(segment, t, x, y);
+		kernel.eval_derivative(segment, t, dx, dy);
+		
+		float dxa, dya, dxb, dyb;
+		kernel.eval_derivative(segment, ta, dxa, dya);
+		kernel.eval_derivative(segment, tb, dxb, dyb);
+		
+		ddx = (dxb - dxa) / (tb - ta);
+		ddy = (dyb - dya) / (tb - ta);
+	}
+	
+}
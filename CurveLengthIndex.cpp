@@ -0,0 +1,127 @@
+/** A Fenwick tree (binary indexed tree) over the lengths of each segment of a curve.
+  * Allows finding the distance to the start of any segment, or the segment at a given distance in O(log n),
+  * and updating a single segment length in O(log n) without having to touch every segment after it. */
+class CurveLengthIndex
+{
+	
+	/** The number of segments in this index. */
+	int count;
+	
+	/** The sum of all segment lengths. */
+	float total;
+	
+	private array<float> values(32);
+	private array<float> tree(33);
+	private int step_max;
+	
+	/** Rebuilds the entire index from the `length` of each vertex/segment in O(n). */
+	void build(array<CurveVertex>@ vertices, const int segment_count)
+	{
+		count = segment_count > 0 ? segment_count : 0;
+		total = 0;
+		
+		while(int(values.length) < count)
+		{
+			values.resize(values.length * 2);
+			tree.resize(values.length + 1);
+		}
+		
+		tree[0] = 0;
+		for(int i = 0; i < count; i++)
+		{
+			const float length = vertices[i].length;
+			values[i] = length;
+			tree[i + 1] = length;
+			total += length;
+		}
+		
+		for(int i = 1; i <= count; i++)
+		{
+			const int j = i + (i & -i);
+			if(j <= count)
+			{
+				tree[j] += tree[i];
+			}
+		}
+		
+		step_max = 1;
+		while(step_max * 2 <= count)
+		{
+			step_max *= 2;
+		}
+	}
+	
+	/** Sets the length of the segment at `index` in O(log n). */
+	void set(const int index, const float length)
+	{
+		if(index < 0 || index >= count)
+			return;
+		
+		const float delta = length - values[index];
+		if(delta == 0)
+			return;
+		
+		values[index] = length;
+		total += delta;
+		
+		for(int i = index + 1; i <= count; i += i & -i)
+		{
+			tree[i] += delta;
+		}
+	}
+	
+	/** Returns the length of the segment at `index`. */
+	float get(const int index) const
+	{
+		return index >= 0 && index < count ? values[index] : 0.0;
+	}
+	
+	/** Returns the distance from the start of the curve to the start of the segment at `index`. */
+	float start_of(const int index) const
+	{
+		float sum = 0;
+		
+		for(int i = index < count ? index : count; i > 0; i -= i & -i)
+		{
+			sum += tree[i];
+		}
+		
+		return sum;
+	}
+	
+	/** Finds the segment containing the given distance.
+	  * @param distance The distance from the start of the curve.
+	  * @param segment_start Receives the distance from the start of the curve to the start of the found segment.
+	  * @return The segment index, or -1 if this index is empty. */
+	int find(const float distance, float &out segment_start) const
+	{
+		segment_start = 0;
+		
+		if(count == 0)
+			return -1;
+		
+		int index = 0;
+		float remaining = distance;
+		
+		for(int step = step_max; step > 0; step /= 2)
+		{
+			const int next = index + step;
+			if(next <= count && tree[next] <= remaining)
+			{
+				index = next;
+				remaining -= tree[next];
+			}
+		}
+		
+		if(index >= count)
+		{
+			index = count - 1;
+			segment_start = total - values[index];
+			return index;
+		}
+		
+		segment_start = distance - remaining;
+		return index;
+	}
+	
+}
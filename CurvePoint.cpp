@@ -27,3 +27,12 @@ class CurvePointW : CurvePoint
 	float w;
 	
 }
+
+/// A point on a curve, and the segment and t value it's at.
+class CurveSegmentPoint : CurvePoint
+{
+	
+	int segment;
+	float t;
+	
+}
@@ -0,0 +1,276 @@
+/** How a `CurveSegment` is evaluated. */
+enum CurveSegmentKind
+{
+	
+	/** The segment has no cached form and must be evaluated by the curve, e.g. b-splines. */
+	GenericSegment,
+	
+	/** A straight line between two points. */
+	LinearSegment,
+	
+	/** A quadratic bezier, or a cubic bezier with one square control point. */
+	QuadraticSegment,
+	
+	/** A cubic bezier or Catmull-Rom segment. */
+	CubicSegment,
+	
+}
+
+/** A flattened, pre-resolved form of a single curve segment, built when the curve is validated.
+  * All control points are absolute, and any fallbacks (square control points, equal weights, etc.) have already been applied,
+  * so evaluating only requires a Horner evaluation of the power basis coefficients. */
+class CurveSegment
+{
+	
+	CurveSegmentKind kind = GenericSegment;
+	
+	/** If true the coefficients are of the weighted control points, and must be divided by the weight. */
+	bool rational;
+	
+	/** The absolute bezier control points. Unused points are set to the end point. */
+	float p1x, p1y, p2x, p2y, p3x, p3y, p4x, p4y;
+	/** The weights of each control point. Only used when `rational` is true. */
+	float r1 = 1, r2 = 1, r3 = 1, r4 = 1;
+	
+	/** The power basis coefficients, such that `x(t) = ax + bx*t + cx*t^2 + dx*t^3`. */
+	float ax, bx, cx, dx;
+	float ay, by, cy, dy;
+	/** The power basis coefficients of the weight. Only used when `rational` is true. */
+	float aw = 1, bw, cw, dw;
+	
+	void set_generic()
+	{
+		kind = GenericSegment;
+		rational = false;
+	}
+	
+	void set_linear(const float p1x, const float p1y, const float p2x, const float p2y)
+	{
+		kind = LinearSegment;
+		rational = false;
+		set_points(p1x, p1y, p1x, p1y, p2x, p2y, p2x, p2y);
+		
+		ax = p1x;
+		ay = p1y;
+		bx = p2x - p1x;
+		by = p2y - p1y;
+		cx = cy = 0;
+		dx = dy = 0;
+	}
+	
+	void set_quadratic(
+		const float p1x, const float p1y, const float p2x, const float p2y, const float p3x, const float p3y)
+	{
+		kind = QuadraticSegment;
+		rational = false;
+		set_points(p1x, p1y, p2x, p2y, p3x, p3y, p3x, p3y);
+		
+		ax = p1x;
+		ay = p1y;
+		bx = 2 * (p2x - p1x);
+		by = 2 * (p2y - p1y);
+		cx = p1x - 2 * p2x + p3x;
+		cy = p1y - 2 * p2y + p3y;
+		dx = dy = 0;
+	}
+	
+	void set_quadratic(
+		const float p1x, const float p1y, const float p2x, const float p2y, const float p3x, const float p3y,
+		const float r1, const float r2, const float r3)
+	{
+		set_quadratic(p1x * r1, p1y * r1, p2x * r2, p2y * r2, p3x * r3, p3y * r3);
+		set_points(p1x, p1y, p2x, p2y, p3x, p3y, p3x, p3y);
+		rational = true;
+		this.r1 = r1;
+		this.r2 = r2;
+		this.r3 = r3;
+		this.r4 = r3;
+		
+		aw = r1;
+		bw = 2 * (r2 - r1);
+		cw = r1 - 2 * r2 + r3;
+		dw = 0;
+	}
+	
+	void set_cubic(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y)
+	{
+		kind = CubicSegment;
+		rational = false;
+		set_points(p1x, p1y, p2x, p2y, p3x, p3y, p4x, p4y);
+		
+		ax = p1x;
+		ay = p1y;
+		bx = 3 * (p2x - p1x);
+		by = 3 * (p2y - p1y);
+		cx = 3 * (p1x - 2 * p2x + p3x);
+		cy = 3 * (p1y - 2 * p2y + p3y);
+		dx = -p1x + 3 * (p2x - p3x) + p4x;
+		dy = -p1y + 3 * (p2y - p3y) + p4y;
+	}
+	
+	void set_cubic(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y,
+		const float r1, const float r2, const float r3, const float r4)
+	{
+		set_cubic(p1x * r1, p1y * r1, p2x * r2, p2y * r2, p3x * r3, p3y * r3, p4x * r4, p4y * r4);
+		set_points(p1x, p1y, p2x, p2y, p3x, p3y, p4x, p4y);
+		rational = true;
+		this.r1 = r1;
+		this.r2 = r2;
+		this.r3 = r3;
+		this.r4 = r4;
+		
+		aw = r1;
+		bw = 3 * (r2 - r1);
+		cw = 3 * (r1 - 2 * r2 + r3);
+		dw = -r1 + 3 * (r2 - r3) + r4;
+	}
+	
+	/** Converts the Catmull-Rom segment between `p2` and `p3` to its equivalent cubic bezier. */
+	void set_catmull_rom(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y,
+		const float tension)
+	{
+		const float st = tension * 6;
+		
+		set_cubic(
+			p2x, p2y,
+			p2x + (p3x - p1x) / st, p2y + (p3y - p1y) / st,
+			p3x - (p4x - p2x) / st, p3y - (p4y - p2y) / st,
+			p3x, p3y);
+	}
+	
+	/** Calculate the position and normal at the given t value. */
+	void eval(const float t, float &out x, float &out y, float &out normal_x, float &out normal_y) const
+	{
+		float tx, ty;
+		eval_point(t, x, y);
+		eval_derivative(t, tx, ty);
+		
+		normal_x = ty;
+		normal_y = -tx;
+		
+		const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+		if(length != 0)
+		{
+			normal_x /= length;
+			normal_y /= length;
+		}
+	}
+	
+	/** Calculate the position at the given t value. */
+	void eval_point(const float t, float &out x, float &out y) const
+	{
+		x = ((dx * t + cx) * t + bx) * t + ax;
+		y = ((dy * t + cy) * t + by) * t + ay;
+		
+		if(rational)
+		{
+			const float w = ((dw * t + cw) * t + bw) * t + aw;
+			x /= w;
+			y /= w;
+		}
+	}
+	
+	/** Calculate the normal at the given t value. */
+	void eval_normal(const float t, float &out normal_x, float &out normal_y) const
+	{
+		float tx, ty;
+		eval_derivative(t, tx, ty);
+		
+		normal_x = ty;
+		normal_y = -tx;
+		
+		const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+		if(length != 0)
+		{
+			normal_x /= length;
+			normal_y /= length;
+		}
+	}
+	
+	/** Calculate the first derivative at the given t value. */
+	void eval_derivative(const float t, float &out out_dx, float &out out_dy) const
+	{
+		out_dx = (3 * dx * t + 2 * cx) * t + bx;
+		out_dy = (3 * dy * t + 2 * cy) * t + by;
+		
+		if(rational)
+		{
+			const float w = ((dw * t + cw) * t + bw) * t + aw;
+			const float dw_dt = (3 * dw * t + 2 * cw) * t + bw;
+			const float x = (((dx * t + cx) * t + bx) * t + ax) / w;
+			const float y = (((dy * t + cy) * t + by) * t + ay) / w;
+			out_dx = (out_dx - x * dw_dt) / w;
+			out_dy = (out_dy - y * dw_dt) / w;
+		}
+	}
+	
+	/** Calculate the position, and first and second derivatives at the given t value. */
+	void eval_derivatives(
+		const float t, float &out x, float &out y,
+		float &out out_dx, float &out out_dy, float &out out_ddx, float &out out_ddy) const
+	{
+		x = ((dx * t + cx) * t + bx) * t + ax;
+		y = ((dy * t + cy) * t + by) * t + ay;
+		out_dx = (3 * dx * t + 2 * cx) * t + bx;
+		out_dy = (3 * dy * t + 2 * cy) * t + by;
+		out_ddx = 6 * dx * t + 2 * cx;
+		out_ddy = 6 * dy * t + 2 * cy;
+		
+		if(rational)
+		{
+			const float w = ((dw * t + cw) * t + bw) * t + aw;
+			const float dw_dt = (3 * dw * t + 2 * cw) * t + bw;
+			const float ddw_dt = 6 * dw * t + 2 * cw;
+			x /= w;
+			y /= w;
+			out_dx = (out_dx - x * dw_dt) / w;
+			out_dy = (out_dy - y * dw_dt) / w;
+			out_ddx = (out_ddx - 2 * out_dx * dw_dt - x * ddw_dt) / w;
+			out_ddy = (out_ddy - 2 * out_dy * dw_dt - y * ddw_dt) / w;
+		}
+	}
+	
+	/** Calculate the exact closest point to `x`, `y`, for the kinds of segments that have a closed form solution,
+	  * i.e. linear and non-rational quadratic segments.
+	  * @return False if the segment has no closed form solution, in which case the outputs are undefined. */
+	bool closest_point(const float x, const float y, float &out t, float &out px, float &out py) const
+	{
+		if(kind == LinearSegment)
+		{
+			const float length_sqr = bx * bx + by * by;
+			t = length_sqr != 0 ? clamp01(((x - ax) * bx + (y - ay) * by) / length_sqr) : 0.0;
+			px = ax + bx * t;
+			py = ay + by * t;
+			return true;
+		}
+		
+		if(kind == QuadraticSegment && !rational)
+		{
+			QuadraticBezier::closest_point(p1x, p1y, p2x, p2y, p3x, p3y, x, y, t, px, py);
+			return true;
+		}
+		
+		return false;
+	}
+	
+	private void set_points(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y)
+	{
+		this.p1x = p1x;
+		this.p1y = p1y;
+		this.p2x = p2x;
+		this.p2y = p2y;
+		this.p3x = p3x;
+		this.p3y = p3y;
+		this.p4x = p4x;
+		this.p4y = p4y;
+	}
+	
+}
@@ -0,0 +1,342 @@
+/** A bounding volume hierarchy over the bounding boxes of the segments of a curve, i.e. each `CurveVertex`'s `x1`, `y1`, `x2`, and `y2`.
+  * Allows finding the segments overlapping a rectangle, or visiting segments in order of distance to a point, without checking every segment.
+  * Since neighbouring segments of a curve are usually also close to each other, the tree is built by recursively halving the range of
+  * segment indices, so leaves always contain consecutive segments and results are returned in ascending order.
+  * This also means the tree never needs to be restructured unless segments are added or removed, and changed segments only need to update
+  * the bounding boxes of the nodes above them. */
+class CurveSegmentBVH
+{
+	
+	/** The maximum number of segments in each leaf node. Changes only take effect when the tree is next rebuilt. */
+	int leaf_size = 4;
+	
+	/** The number of segments in the tree. */
+	int segment_count;
+	
+	/** The number of nodes in the tree. */
+	int node_count;
+	
+	private array<CurveVertex>@ vertices;
+	
+	/** The bounds of each node. */
+	private array<float> node_x1, node_y1, node_x2, node_y2;
+	/** The range of segments covered by each node. The left child of a node always immediately follows it. */
+	private array<int> node_start, node_end;
+	/** The right child of each node, or -1 for leaf nodes. */
+	private array<int> node_right;
+	private array<int> node_parent;
+	/** The leaf node containing each segment. */
+	private array<int> segment_leaf;
+	private array<int> stack;
+	
+	/** The priority queue used by `nearest_next`. Nodes are stored as their index, and segments as `-(segment + 1)`. */
+	private array<float> heap_dist;
+	private array<int> heap_item;
+	private int heap_size;
+	private float nearest_x, nearest_y;
+	
+	/** Removes all segments. */
+	void clear()
+	{
+		segment_count = 0;
+		node_count = 0;
+		heap_size = 0;
+	}
+	
+	/** Updates the bounds of any invalidated segments, or rebuilds the tree if `rebuild` is true or the number of segments has changed.
+	  * @param vertices The vertices of the curve. Each must have a valid bounding box.
+	  * @param segment_count The number of segments. */
+	void update(array<CurveVertex>@ vertices, const int segment_count, const bool rebuild)
+	{
+		@this.vertices = vertices;
+		
+		if(rebuild || this.segment_count != segment_count || node_count == 0)
+		{
+			build(segment_count);
+			return;
+		}
+		
+		for(int i = 0; i < segment_count; i++)
+		{
+			if(!vertices[i].invalidated)
+				continue;
+			
+			// Skip the rest of the segments in this leaf since they will all be refitted together.
+			const int leaf = segment_leaf[i];
+			refit(leaf);
+			i = node_end[leaf] - 1;
+		}
+	}
+	
+	/** Finds all segments whose bounding box overlaps the given rectangle.
+	  * @param out_segments Receives the segment indices in ascending order. Resized if needed.
+	  * @return The number of segments found. */
+	int query_rect(const float x1, const float y1, const float x2, const float y2, array<int>@ out_segments)
+	{
+		if(node_count == 0)
+			return 0;
+		
+		if(int(stack.length) < node_count)
+		{
+			stack.resize(node_count);
+		}
+		
+		int count = 0;
+		int stack_size = 0;
+		stack[stack_size++] = 0;
+		
+		while(stack_size > 0)
+		{
+			const int n = stack[--stack_size];
+			
+			if(node_x1[n] > x2 || node_x2[n] < x1 || node_y1[n] > y2 || node_y2[n] < y1)
+				continue;
+			
+			if(node_right[n] != -1)
+			{
+				// Push the right child first so that the left is visited first, keeping the results in order.
+				stack[stack_size++] = node_right[n];
+				stack[stack_size++] = n + 1;
+				continue;
+			}
+			
+			for(int i = node_start[n]; i < node_end[n]; i++)
+			{
+				CurveVertex@ v = vertices[i];
+				if(v.x1 > x2 || v.x2 < x1 || v.y1 > y2 || v.y2 < y1)
+					continue;
+				
+				if(count >= int(out_segments.length))
+				{
+					out_segments.resize(max(count * 2, 16));
+				}
+				
+				out_segments[count++] = i;
+			}
+		}
+		
+		return count;
+	}
+	
+	/** Starts visiting segments in order of the distance from the given point to their bounding box. Call `nearest_next` to get each segment. */
+	void nearest_start(const float x, const float y)
+	{
+		nearest_x = x;
+		nearest_y = y;
+		heap_size = 0;
+		
+		if(node_count > 0)
+		{
+			heap_push(box_distance(node_x1[0], node_y1[0], node_x2[0], node_y2[0]), 0);
+		}
+	}
+	
+	/** Returns the next closest segment since `nearest_start` was called.
+	  * @param dist_sqr Receives the squared distance from the point to the segment's bounding box. Segments are returned in order
+	  *   of increasing distance, so this can be used to stop once no remaining segment could be closer than something already found.
+	  * @return False if there are no more segments. */
+	bool nearest_next(int &out segment, float &out dist_sqr)
+	{
+		while(heap_size > 0)
+		{
+			const int item = heap_item[0];
+			const float dist = heap_dist[0];
+			heap_pop();
+			
+			if(item < 0)
+			{
+				segment = -item - 1;
+				dist_sqr = dist;
+				return true;
+			}
+			
+			if(node_right[item] != -1)
+			{
+				const int left = item + 1;
+				const int right = node_right[item];
+				heap_push(box_distance(node_x1[left], node_y1[left], node_x2[left], node_y2[left]), left);
+				heap_push(box_distance(node_x1[right], node_y1[right], node_x2[right], node_y2[right]), right);
+				continue;
+			}
+			
+			for(int i = node_start[item]; i < node_end[item]; i++)
+			{
+				CurveVertex@ v = vertices[i];
+				heap_push(box_distance(v.x1, v.y1, v.x2, v.y2), -i - 1);
+			}
+		}
+		
+		segment = -1;
+		dist_sqr = INFINITY;
+		return false;
+	}
+	
+	private void build(const int segment_count)
+	{
+		this.segment_count = segment_count;
+		node_count = 0;
+		heap_size = 0;
+		
+		if(segment_count <= 0)
+			return;
+		
+		// A full binary tree over n leaves has 2n - 1 nodes, and there can't be more leaves than segments.
+		const int capacity = segment_count * 2;
+		if(int(node_x1.length) < capacity)
+		{
+			node_x1.resize(capacity);
+			node_y1.resize(capacity);
+			node_x2.resize(capacity);
+			node_y2.resize(capacity);
+			node_start.resize(capacity);
+			node_end.resize(capacity);
+			node_right.resize(capacity);
+			node_parent.resize(capacity);
+		}
+		if(int(segment_leaf.length) < segment_count)
+		{
+			segment_leaf.resize(segment_count);
+		}
+		
+		build_node(0, segment_count, -1);
+	}
+	
+	/** Adds the node covering the given range of segments, and then its children.
+	  * @return The index of the node. */
+	private int build_node(const int start, const int end, const int parent)
+	{
+		const int n = node_count++;
+		node_start[n] = start;
+		node_end[n] = end;
+		node_parent[n] = parent;
+		
+		if(end - start <= max(leaf_size, 1))
+		{
+			node_right[n] = -1;
+			
+			for(int i = start; i < end; i++)
+			{
+				segment_leaf[i] = n;
+			}
+			
+			fit_leaf(n);
+			return n;
+		}
+		
+		const int mid = (start + end) / 2;
+		build_node(start, mid, n);
+		node_right[n] = build_node(mid, end, n);
+		fit_node(n);
+		
+		return n;
+	}
+	
+	/** Recalculates the bounds of a leaf and every node above it. */
+	private void refit(int n)
+	{
+		fit_leaf(n);
+		
+		n = node_parent[n];
+		while(n != -1)
+		{
+			fit_node(n);
+			n = node_parent[n];
+		}
+	}
+	
+	private void fit_leaf(const int n)
+	{
+		float x1 = INFINITY;
+		float y1 = INFINITY;
+		float x2 = -INFINITY;
+		float y2 = -INFINITY;
+		
+		for(int i = node_start[n]; i < node_end[n]; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			if(v.x1 < x1) x1 = v.x1;
+			if(v.y1 < y1) y1 = v.y1;
+			if(v.x2 > x2) x2 = v.x2;
+			if(v.y2 > y2) y2 = v.y2;
+		}
+		
+		node_x1[n] = x1;
+		node_y1[n] = y1;
+		node_x2[n] = x2;
+		node_y2[n] = y2;
+	}
+	
+	private void fit_node(const int n)
+	{
+		const int l = n + 1;
+		const int r = node_right[n];
+		node_x1[n] = min(node_x1[l], node_x1[r]);
+		node_y1[n] = min(node_y1[l], node_y1[r]);
+		node_x2[n] = max(node_x2[l], node_x2[r]);
+		node_y2[n] = max(node_y2[l], node_y2[r]);
+	}
+	
+	private float box_distance(const float x1, const float y1, const float x2, const float y2)
+	{
+		const float dx = nearest_x < x1 ? x1 - nearest_x : nearest_x > x2 ? nearest_x - x2 : 0.0;
+		const float dy = nearest_y < y1 ? y1 - nearest_y : nearest_y > y2 ? nearest_y - y2 : 0.0;
+		return dx * dx + dy * dy;
+	}
+	
+	private void heap_push(const float dist, const int item)
+	{
+		if(heap_size >= int(heap_dist.length))
+		{
+			const int size = max(heap_size * 2, 32);
+			heap_dist.resize(size);
+			heap_item.resize(size);
+		}
+		
+		int i = heap_size++;
+		while(i > 0)
+		{
+			const int parent = (i - 1) / 2;
+			if(heap_dist[parent] <= dist)
+				break;
+			
+			heap_dist[i] = heap_dist[parent];
+			heap_item[i] = heap_item[parent];
+			i = parent;
+		}
+		
+		heap_dist[i] = dist;
+		heap_item[i] = item;
+	}
+	
+	private void heap_pop()
+	{
+		heap_size--;
+		if(heap_size == 0)
+			return;
+		
+		const float dist = heap_dist[heap_size];
+		const int item = heap_item[heap_size];
+		
+		int i = 0;
+		while(true)
+		{
+			int child = i * 2 + 1;
+			if(child >= heap_size)
+				break;
+			if(child + 1 < heap_size && heap_dist[child + 1] < heap_dist[child])
+			{
+				child++;
+			}
+			if(heap_dist[child] >= dist)
+				break;
+			
+			heap_dist[i] = heap_dist[child];
+			heap_item[i] = heap_item[child];
+			i = child;
+		}
+		
+		heap_dist[i] = dist;
+		heap_item[i] = item;
+	}
+	
+}
@@ -0,0 +1,161 @@
+/** Steps along a non-rational polynomial segment at uniform t intervals using forward differencing, so that each step only costs a few
+  * additions instead of a full evaluation of the curve.
+  * The position (and optionally normal) is recalculated directly every `refresh_interval` steps, and at the final step, so floating point
+  * errors can not accumulate.
+  *
+  * Usage:
+  *   if(stepper.start(segment, count))
+  *   {
+  *       do { ...use stepper.t, stepper.x, stepper.y... } while(stepper.step());
+  *   } */
+class CurveStepper
+{
+	
+	/** How many steps are taken before the position is recalculated directly. If <= 0 it is only recalculated at the final step. */
+	int refresh_interval = 32;
+	
+	/** If false only the position is calculated and `normal_x`/`normal_y` are left unchanged. */
+	bool calculate_normals = true;
+	
+	/** The current step, between 0 and `count`. */
+	int index;
+	/** The total number of steps. */
+	int count;
+	
+	/** The t value, position, and normal at the current step. */
+	float t;
+	float x, y;
+	float normal_x, normal_y;
+	
+	private float ax, bx, cx, dx;
+	private float ay, by, cy, dy;
+	private float h;
+	
+	/** The forward differences of the position. */
+	private float px1, px2, px3;
+	private float py1, py2, py3;
+	
+	/** The unnormalised tangent and its forward differences. */
+	private float tx, tx1, tx2;
+	private float ty, ty1, ty2;
+	
+	/** Starts stepping along the given segment.
+	  * @param count The number of steps. The stepper will visit `count + 1` points, including both ends.
+	  * @return False if the segment can not be stepped, e.g. if it is rational or a b-spline, in which case the curve must be evaluated
+	  *   directly instead. */
+	bool start(const CurveSegment@ segment, const int count)
+	{
+		if(segment is null || segment.kind == GenericSegment || segment.rational)
+			return false;
+		
+		return start(
+			segment.ax, segment.bx, segment.cx, segment.dx,
+			segment.ay, segment.by, segment.cy, segment.dy,
+			count);
+	}
+	
+	/** Starts stepping along a cubic polynomial defined by its power basis coefficients, such that `x(t) = ax + bx*t + cx*t^2 + dx*t^3`.
+	  * @param count The number of steps. The stepper will visit `count + 1` points, including both ends. */
+	bool start(
+		const float ax, const float bx, const float cx, const float dx,
+		const float ay, const float by, const float cy, const float dy,
+		const int count)
+	{
+		if(count <= 0)
+			return false;
+		
+		this.ax = ax;
+		this.bx = bx;
+		this.cx = cx;
+		this.dx = dx;
+		this.ay = ay;
+		this.by = by;
+		this.cy = cy;
+		this.dy = dy;
+		
+		this.count = count;
+		h = 1.0 / count;
+		index = 0;
+		refresh();
+		
+		return true;
+	}
+	
+	/** Advances to the next step.
+	  * @return False if the last step had already been reached. */
+	bool step()
+	{
+		if(index >= count)
+			return false;
+		
+		index++;
+		
+		if(index == count || refresh_interval > 0 && index % refresh_interval == 0)
+		{
+			refresh();
+			return true;
+		}
+		
+		t = index * h;
+		
+		x += px1;
+		px1 += px2;
+		px2 += px3;
+		y += py1;
+		py1 += py2;
+		py2 += py3;
+		
+		if(calculate_normals)
+		{
+			tx += tx1;
+			tx1 += tx2;
+			ty += ty1;
+			ty1 += ty2;
+			update_normal();
+		}
+		
+		return true;
+	}
+	
+	/** Calculates the position and forward differences at the current step directly. */
+	private void refresh()
+	{
+		t = index == count ? 1.0 : index * h;
+		
+		x = ((dx * t + cx) * t + bx) * t + ax;
+		y = ((dy * t + cy) * t + by) * t + ay;
+		
+		const float hh = h * h;
+		px1 = h * (bx + cx * (2 * t + h) + dx * (3 * t * t + 3 * t * h + hh));
+		py1 = h * (by + cy * (2 * t + h) + dy * (3 * t * t + 3 * t * h + hh));
+		px2 = hh * (2 * cx + 6 * dx * (t + h));
+		py2 = hh * (2 * cy + 6 * dy * (t + h));
+		px3 = 6 * dx * hh * h;
+		py3 = 6 * dy * hh * h;
+		
+		if(!calculate_normals)
+			return;
+		
+		tx = (3 * dx * t + 2 * cx) * t + bx;
+		ty = (3 * dy * t + 2 * cy) * t + by;
+		tx1 = 2 * cx * h + 3 * dx * (2 * t * h + hh);
+		ty1 = 2 * cy * h + 3 * dy * (2 * t * h + hh);
+		tx2 = 6 * dx * hh;
+		ty2 = 6 * dy * hh;
+		update_normal();
+	}
+	
+	private void update_normal()
+	{
+		normal_x = ty;
+		normal_y = -tx;
+		
+		const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+		if(length != 0)
+		{
+			normal_x /= length;
+			normal_y /= length;
+		}
+	}
+	
+}
@@ -34,3 +34,22 @@ enum CurveEndControl
 	Manual,
 	
 }
+
+/** Controls how the pre-calculated subdivisions and length of a curve are calculated. */
+enum CurveLengthMode
+{
+	
+	/** Each segment is recursively subdivided based on the angle and length settings, and the length of the resulting chords are summed. */
+	Subdivision,
+	
+	/** Each segment is split into uniform divisions, and the length of each division is integrated with adaptive Gauss-Legendre quadrature.
+	  * With the default settings each segment costs 7 position and at least 42 derivative evaluations, which is more than `Subdivision`
+	  * with its defaults, but the length converges much faster as evaluations are added and comes with an error estimate.
+	  * See `Curve::calculate_arc_lengths_quadrature`. */
+	Quadrature,
+	
+	/** Each segment is subdivided until no arc deviates from the curve by more than a world space tolerance, so the number of arcs
+	  * depends on the size and complexity of each segment instead of fixed division counts. */
+	Tolerance,
+	
+}
@@ -48,6 +48,9 @@ class CurveVertex : CurveControlPoint
 	
 	bool invalidated = true;
 	
+	/** The arcs of this segment are out of date, and will be calculated the next time they are needed. Only used in lazy mode. */
+	bool arcs_pending;
+	
 	/** The bounding box of this curve segment. */
 	float x1, y1;
 	float x2, y2;
@@ -55,9 +58,18 @@ class CurveVertex : CurveControlPoint
 	/** The approximated length of the curve segment starting with this vertex. */
 	float length;
 	
-	/** A precomputed set of points along the curve, mapping raw t values to real distances/uniform t values along the curve. */
-	array<CurveArc> arcs;
+	/** The estimated error of `length`. Only calculated when using `CurveLengthMode::Quadrature`. */
+	float length_error;
+	
+	/** The largest distance between the curve and the chord of any of its arcs. Only calculated when using `CurveLengthMode::Tolerance`. */
+	float arc_deviation;
+	
+	/** The range of precomputed points along the curve in the owning curve's `CurveArcs`, mapping raw t values to real distances/uniform t values
+	  * along the curve. */
+	int arc_offset;
 	int arc_count;
+	/** The number of entries reserved for this segment in the `CurveArcs`. */
+	int arc_capacity;
 	
 	CurveVertex() { }
 	
@@ -121,14 +133,16 @@ class CurveVertex : CurveControlPoint
 		return this;
 	}
 	
-	CurveArc@ arc_from_end(const int offset=0)
+	/** Returns the index of an arc in the owning curve's `CurveArcs`, counting back from the last arc of this segment. */
+	int arc_from_end(const int offset=0) const
 	{
-		return offset < arc_count ? arcs[arc_count - 1 - offset] : arcs[0];
+		return offset < arc_count ? arc_offset + arc_count - 1 - offset : arc_offset;
 	}
 	
-	CurveArc@ arc_from_start(const int offset=0)
+	/** Returns the index of an arc in the owning curve's `CurveArcs`, counting from the first arc of this segment. */
+	int arc_from_start(const int offset=0) const
 	{
-		return offset < arc_count ? arcs[offset] : arcs[0];
+		return offset < arc_count ? arc_offset + offset : arc_offset;
 	}
 	
 	void set_control_type(const CurveControlType type)
@@ -140,27 +154,6 @@ class CurveVertex : CurveControlPoint
 	
 }
 
-class CurveArc
-{
-	
-	/** The t value of this point relative to its segment. */
-	float t;
-	/** The position of this arc. */
-	float x, y;
-	float dx, dy;
-	/** The normalised delta/direction of this arc segment. */
-	float nx, ny;
-	/** The squared length of this arc segment. */
-	float length_sqr;
-	/** The length of this arc segment. */
-	float length;
-	/** The total length from the start of the curve to the end of this arc. */
-	float total_length;
-	/** The difference in the t value from the start of this segment to the end. */
-	float t_length;
-	
-}
-
 enum CurveControlType
 {
 	
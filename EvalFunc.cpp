@@ -17,4 +17,11 @@ namespace Curve
 	  * @param y The y value of the returned point on the curve. */
 	funcdef void EvalPointFunc(const int, const float, float &out, float &out);
 	
+	/** A function to evaluate the first derivative of a curve at the given segment index and t value.
+	  * @param segment The segment index.
+	  * @param t The t value within the segment in the range 0..1.
+	  * @param dx The x value of the derivative with respect to t.
+	  * @param dy The y value of the derivative with respect to t. */
+	funcdef void EvalDerivativeFunc(const int, const float, float &out, float &out);
+	
 }
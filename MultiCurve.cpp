@@ -1,4 +1,5 @@
 #include 'b_spline.cpp';
+#include 'bezier.cpp';
 #include 'catmull_rom.cpp';
 #include 'catmull_rom_to_cubic_bezier.cpp';
 #include 'cubic.cpp';
@@ -12,11 +13,29 @@
 #include 'quadratic_bounding_box.cpp';
 #include 'quadratic_bounding_box_rational.cpp';
 #include 'quadratic_split.cpp';
+#include 'quadratic_closest_point.cpp';
 #include 'quadratic_split_rational.cpp';
 
 #include 'CurveVertex.cpp';
+#include 'CurveSegment.cpp';
+#include 'CurveStepper.cpp';
+#include 'BSplineCursor.cpp';
+#include 'CurveKernel.cpp';
+#include 'CurveArcs.cpp';
+#include 'CurveDistanceFit.cpp';
+#include 'CurveArcGrid.cpp';
+#include 'CurveSegmentBVH.cpp';
+#include 'CurveClosestPoint.cpp';
+#include 'CurveClosestPointStats.cpp';
+#include 'CurveClosestPointsScratch.cpp';
+#include 'CurveLengthIndex.cpp';
+#include 'arc_length_mapping.cpp';
 #include 'calculate_arc_lengths.cpp';
+#include 'calculate_arc_lengths_quadrature.cpp';
+#include 'calculate_arc_lengths_tolerance.cpp';
 #include 'closest_point.cpp';
+#include 'closest_points.cpp';
+#include 'points_within.cpp';
 
 #include 'CurveControlPointDrag.cpp';
 #include 'CurveDrag.cpp';
@@ -61,6 +80,11 @@ class MultiCurve
 	/** If true the curve will pass touch the first and last vertices. */
 	[persist] private bool _b_spline_clamped = true;
 	
+	/** If true, b-splines are converted to a rational bezier curve per knot span when validating, which makes evaluating them much faster,
+	  * and allows calculating exact bounding boxes for degree 2 and 3 b-splines.
+	  * Changes will only take effect when the curve is next validated. */
+	bool b_spline_bezier = false;
+	
 	/** Controls the base number of the pre-calculated subdivisions of this curve.
 	  * These subdivisions are required for certain operations, e.g. approximating the curve length, or finding
 	  * a closest point on the curve.
@@ -69,8 +93,33 @@ class MultiCurve
 	  * See `Curve::calculate_arc_lengths` for descriptions of these properties. */
 	MultiCuveSubdivisionSettings subdivision_settings;
 	
-	/** The total (approximate) length of this curve. */
-	float length;
+	/** If true, the arcs of each segment are not calculated when validating, and are instead calculated the first time they are needed,
+	  * e.g. by `closest_point` or `distance_to_t`. Bounding boxes are still calculated when validating.
+	  * In this mode the methods that need arcs also validate the curve first if needed, so the curve doesn't have to be validated
+	  * manually before calling them. When false, the curve must be validated before calling them, as before.
+	  * Changes will only take effect when the curve is next validated. */
+	bool lazy_arcs = false;
+	
+	/** The number of iterations and curve evaluations used by the last `closest_point` or `closest_point_warm` call. */
+	CurveClosestPointStats closest_point_stats;
+	
+	/** The total (approximate) length of this curve. When `lazy_arcs` is true, reading this first calculates any pending arcs. */
+	float length
+	{
+		get
+		{
+			validate_arcs();
+			return _length;
+		}
+		set { _length = value; }
+	}
+	
+	/** The estimated error of `length`. Only calculated when `subdivision_settings.mode` is `Quadrature`, otherwise 0. */
+	float length_error;
+	
+	/** The largest distance between the curve and the chord of any of its arcs. Only calculated when `subdivision_settings.mode` is
+	  * `Tolerance`, otherwise 0. */
+	float arc_deviation;
 	
 	/** This curve's bounding box. */
 	float x1, y1, x2, y2;
@@ -89,14 +138,84 @@ class MultiCurve
 	/** Control points may not be initialised after changing curve type. */
 	private bool invalidated_control_points = true;
 	
+	/** Vertices have been added or removed, so the segment indices in `length_index` no longer line up. */
+	private bool invalidated_length_index = true;
+	
+	/** Vertices have been added or removed, so `_segment_bvh` must be rebuilt. Tracked separately from `invalidated_length_index`, which
+	  * is cleared by `calculate_arcs` before the tree is updated, and stays set in lazy mode until the arcs are calculated. */
+	private bool invalidated_segment_bvh = true;
+	
+	/** One or more segments are waiting for their arcs to be calculated in lazy mode. */
+	private bool arcs_pending;
+	
+	private float _length;
+	
+	/** Allows quickly looking up the distance to the start of any segment. */
+	private CurveLengthIndex length_index;
+	
+	/** The arcs of every segment, referenced by each vertex's `arc_offset` and `arc_count`. */
+	private CurveArcs _arcs;
+	
+	/** Only used when `subdivision_settings.distance_fit_order` is > 0. */
+	private CurveDistanceFit _distance_fit;
+	
+	/** Only used when `subdivision_settings.arc_grid` is true. */
+	private CurveArcGrid arc_grid;
+	
+	private CurveSegmentBVH _segment_bvh;
+	/** Scratch segment indices used by `closest_point`. */
+	private array<int> bvh_segments;
+	/** Scratch segment indices used by `closest_point_warm`. */
+	private array<int> warm_segments;
+	/** Scratch heap used by `closest_point` to order segments by distance. */
+	private array<float> heap_dist;
+	private array<int> heap_segment;
+	/** Scratch arrays used by `closest_points`. */
+	private CurveClosestPointsScratch closest_points_scratch;
+	
+	/** Incremented each time the curve is validated after being changed. */
+	private int _version;
+	
+	/** The resolved power basis form of each segment, used to speed up evaluation once the curve has been validated. */
+	private array<CurveSegment> segments;
+	private int segments_count;
+	private CurveType segments_type = CurveType::Linear;
+	private bool segments_closed;
+	private float segments_tension = 1;
+	
+	/** The segments have been rebuilt during the current `validate` call, so can be used before it completes. */
+	private bool segments_updated;
+	
+	/** Scratch t values used by `eval_many`. */
+	private array<float> eval_many_t;
+	/** Holds the resolved form of a segment for `eval_many` when the curve has been invalidated since `segments` were built. */
+	private CurveSegment eval_many_segment_scratch;
+	
 	private BSpline@ b_spline;
+	/** Caches the b-spline parameters and last knot span, so that evaluating along the curve doesn't need to search for each span.
+	  * Only valid while the b-spline knots are. */
+	private BSplineCursor b_spline_cursor;
 	
 	/** Temp points used when calculating automatic end control points. */
 	private CurveVertex p0;
 	private CurveVertex p3;
+	/** `p0` and `p3` hold the resolved Catmull-Rom end control points, calculated once by `validate`. */
+	private bool catmull_rom_ends_cached;
+	/** The end control points have been resolved during the current `validate` call, so can be used before it completes. */
+	private bool catmull_rom_ends_updated;
+	/** The Manual end control points `p0` and `p3` were resolved from, used to detect them being moved without invalidating the curve. */
+	private float catmull_rom_start_x, catmull_rom_start_y;
+	private float catmull_rom_end_x, catmull_rom_end_y;
 	
 	private Curve::EvalFunc@ eval_func_def;
 	private Curve::EvalPointFunc@ eval_point_func_def;
+	private Curve::EvalDerivativeFunc@ eval_derivative_func_def;
+	
+	/** The kernel passed to the arc length and closest point routines, selected once per `validate` by `update_kernel`. */
+	private CurveKernel@ kernel;
+	private CurveSegmentKernel segment_kernel;
+	private BSplineKernel b_spline_kernel;
+	private CurveFuncKernel@ func_kernel;
 	
 	// -- Editing/dragging stuff
 	
@@ -108,6 +227,29 @@ class MultiCurve
 	{
 		@eval_func_def = Curve::EvalFunc(eval);
 		@eval_point_func_def = Curve::EvalPointFunc(eval_point);
+		@eval_derivative_func_def = Curve::EvalDerivativeFunc(eval_derivative);
+		@func_kernel = CurveFuncKernel(eval_func_def, eval_point_func_def, eval_derivative_func_def);
+		@kernel = func_kernel;
+	}
+	
+	/** The pre-calculated subdivisions of this curve. Each vertex/segment references a range within these using `arc_offset` and `arc_count`.
+	  * Only valid after the curve has been validated. */
+	CurveArcs@ arcs
+	{
+		get { return @_arcs; }
+	}
+	
+	/** The fitted inverse arc lengths. Only valid after the curve has been validated with `subdivision_settings.distance_fit_order` > 0.
+	  * Can be used to check the achieved `max_error`, and how many segments could not be fitted. */
+	const CurveDistanceFit@ distance_fit
+	{
+		get const { return @_distance_fit; }
+	}
+	
+	/** The bounding volume hierarchy over the bounding box of each segment. Only valid after the curve has been validated. */
+	CurveSegmentBVH@ segment_bvh
+	{
+		get { return @_segment_bvh; }
 	}
 	
 	CurveEndControl end_controls
@@ -125,6 +267,8 @@ class MultiCurve
 				check_control_point_start();
 				check_control_point_end();
 			}
+			
+			invalidate_catmull_rom_ends();
 		}
 	}
 	
@@ -161,6 +305,8 @@ class MultiCurve
 			_closed = value;
 			
 			invalidated = true;
+			invalidated_length_index = true;
+			invalidated_segment_bvh = true;
 			invalidated_b_spline_knots = true;
 			invalidated_b_spline_vertices = true;
 			
@@ -230,6 +376,13 @@ class MultiCurve
 		get const { return invalidated; }
 	}
 	
+	/** Changes each time the curve is validated after being modified, so can be compared with a previous value to check if anything
+	  * derived from the curve needs to be updated. */
+	int version
+	{
+		get const { return _version; }
+	}
+	
 	const bool is_end_control(CurveControlPoint@ p)
 	{
 		return @p == @control_point_start || @p == @control_point_end;
@@ -310,26 +463,67 @@ class MultiCurve
 	  * Recalculates cached values such as the bounding box, curve length, etc. */
 	void validate()
 	{
+		// The global tension and Manual end control points can be set directly, so make sure changes to them are picked up.
+		if(_type == CurveType::CatmullRom)
+		{
+			if(segments_tension != tension)
+			{
+				invalidate();
+			}
+			else if(catmull_rom_ends_moved())
+			{
+				invalidate_catmull_rom_ends();
+			}
+		}
+		
 		if(!invalidated)
 			return;
 		
+		_version++;
+		
 		if(invalidated_control_points)
 		{
 			init_bezier_control_points();
 			invalidated_control_points = false;
 		}
 		
+		update_catmull_rom_ends();
 		validate_b_spline();
+		update_segments();
+		update_kernel();
 		
 		// -- Calculate arc lengths.
 		
-		length = Curve::calculate_arc_lengths(
-			@vertices, vertex_count, _closed,
-			eval_func_def, true, _type != Linear ? subdivision_settings.count : 1,
-			_type != Linear ? subdivision_settings.angle_min * DEG2RAD : 0,
-			subdivision_settings.max_stretch_factor, subdivision_settings.length_min,
-			subdivision_settings.max_subdivisions,
-			subdivision_settings.angle_max * DEG2RAD, subdivision_settings.length_max);
+		const int end = segment_index_max;
+		
+		if(lazy_arcs)
+		{
+			for(int i = 0; i <= end; i++)
+			{
+				CurveVertex@ v = vertices[i];
+				if(v.invalidated)
+				{
+					v.arcs_pending = true;
+					arcs_pending = true;
+				}
+			}
+		}
+		else
+		{
+			// Pick up any segments left over from lazy mode.
+			if(arcs_pending)
+			{
+				for(int i = 0; i <= end; i++)
+				{
+					CurveVertex@ v = vertices[i];
+					v.invalidated = v.invalidated || v.arcs_pending;
+					v.arcs_pending = false;
+				}
+				arcs_pending = false;
+			}
+			
+			calculate_arcs();
+		}
 		
 		// -- Calculate the bounding box.
 		
@@ -358,15 +552,180 @@ class MultiCurve
 				break;
 		}
 		
+		_segment_bvh.update(@vertices, end + 1, invalidated_segment_bvh);
+		invalidated_segment_bvh = false;
+		
 		// -- Finish
 		
 		invalidated = false;
+		segments_updated = false;
+		catmull_rom_ends_updated = false;
+		
+		for(int i = 0; i <= end; i++)
+		{
+			vertices[i].invalidated = false;
+		}
+	}
+	
+	/** Only required when `lazy_arcs` is true, otherwise does nothing.
+	  * Validates the curve if needed, and calculates the arcs of any segments that have changed since they were last calculated.
+	  * This is called automatically by the methods that require arcs, e.g. `closest_point`, and the mapping methods.
+	  * If a region is given, only segments whose bounding box overlaps it, and their neighbours, will be calculated. */
+	void validate_arcs(
+		const float region_x1=-INFINITY, const float region_y1=-INFINITY,
+		const float region_x2=INFINITY, const float region_y2=INFINITY)
+	{
+		if(!lazy_arcs)
+			return;
+		
+		validate();
+		
+		if(!arcs_pending)
+			return;
 		
 		const int end = segment_index_max;
+		const bool all = region_x1 == -INFINITY && region_y1 == -INFINITY && region_x2 == INFINITY && region_y2 == INFINITY;
+		bool any_remaining = false;
+		
+		// Flag the segments to calculate using `invalidated`, which will be false for all vertices after validating.
+		for(int i = 0; i <= end; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			if(!v.arcs_pending)
+				continue;
+			
+			if(!all && (v.x1 > region_x2 || v.x2 < region_x1 || v.y1 > region_y2 || v.y2 < region_y1))
+				continue;
+			
+			v.invalidated = true;
+			
+			// Neighbouring arcs are also used when refining the closest point.
+			if(i > 0 || _closed)
+			{
+				vertices[i > 0 ? i - 1 : end].invalidated = true;
+			}
+			if(i < end || _closed)
+			{
+				vertices[i < end ? i + 1 : 0].invalidated = true;
+			}
+		}
+		
+		for(int i = 0; i <= end; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			
+			// Neighbours that are already up to date don't need to be recalculated.
+			v.invalidated = v.invalidated && v.arcs_pending;
+			
+			if(v.invalidated)
+			{
+				v.arcs_pending = false;
+			}
+			else if(v.arcs_pending)
+			{
+				any_remaining = true;
+			}
+		}
+		
+		calculate_arcs();
+		
 		for(int i = 0; i <= end; i++)
 		{
 			vertices[i].invalidated = false;
 		}
+		
+		arcs_pending = any_remaining;
+	}
+	
+	/** Calculates the arcs, length, and dependent caches of all invalidated segments using the current `subdivision_settings`. */
+	private void calculate_arcs()
+	{
+		if(subdivision_settings.mode == Quadrature)
+		{
+			Curve::calculate_arc_lengths_quadrature(
+				@vertices, vertex_count, _closed, _arcs,
+				kernel,
+				true, _type != Linear ? subdivision_settings.count : 1,
+				subdivision_settings.quadrature_tolerance, _type != Linear ? subdivision_settings.quadrature_max_depth : 0,
+				length_error);
+			arc_deviation = 0;
+		}
+		else if(subdivision_settings.mode == Tolerance)
+		{
+			Curve::calculate_arc_lengths_tolerance(
+				@vertices, vertex_count, _closed, _arcs,
+				kernel,
+				true, subdivision_settings.tolerance, _type != Linear ? subdivision_settings.tolerance_max_subdivisions : 0,
+				arc_deviation);
+			length_error = 0;
+		}
+		else
+		{
+			Curve::calculate_arc_lengths(
+				@vertices, vertex_count, _closed, _arcs,
+				kernel, true, _type != Linear ? subdivision_settings.count : 1,
+				_type != Linear ? subdivision_settings.angle_min * DEG2RAD : 0,
+				subdivision_settings.max_stretch_factor, subdivision_settings.length_min,
+				subdivision_settings.max_subdivisions,
+				subdivision_settings.angle_max * DEG2RAD, subdivision_settings.length_max,
+				segments);
+			length_error = 0;
+			arc_deviation = 0;
+		}
+		
+		const bool structure_changed = invalidated_length_index;
+		update_length_index();
+		_length = length_index.total;
+		
+		update_distance_fit(structure_changed);
+		update_arc_grid(structure_changed);
+	}
+	
+	/** Updates the length of any invalidated segments in O(log n) each, or rebuilds the index if any vertices were added or removed. */
+	private void update_length_index()
+	{
+		const int segment_count = segment_index_max + 1;
+		
+		if(invalidated_length_index || length_index.count != segment_count)
+		{
+			length_index.build(@vertices, segment_count);
+			invalidated_length_index = false;
+			return;
+		}
+		
+		for(int i = 0; i < segment_count; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			if(v.invalidated)
+			{
+				length_index.set(i, v.length);
+			}
+		}
+	}
+	
+	private void update_arc_grid(const bool rebuild)
+	{
+		if(!subdivision_settings.arc_grid)
+		{
+			arc_grid.clear();
+			return;
+		}
+		
+		arc_grid.update(@vertices, segment_index_max + 1, _arcs, subdivision_settings.arc_grid_cell_size, rebuild);
+	}
+	
+	private void update_distance_fit(const bool rebuild)
+	{
+		if(subdivision_settings.distance_fit_order <= 0)
+		{
+			_distance_fit.clear();
+			return;
+		}
+		
+		_distance_fit.update(
+			@vertices, segment_index_max + 1, _arcs,
+			subdivision_settings.distance_fit_order, subdivision_settings.distance_fit_tolerance,
+			rebuild);
 	}
 	
 	private void validate_b_spline()
@@ -384,6 +743,226 @@ class MultiCurve
 			b_spline.generate_knots(_b_spline_degree, _b_spline_clamped, _closed);
 			invalidated_b_spline_knots = false;
 		}
+		
+		b_spline_cursor.start(b_spline, _b_spline_degree, _b_spline_clamped, _closed);
+		
+		if(!b_spline_bezier)
+		{
+			b_spline.clear_bezier();
+		}
+		else if(!b_spline.has_bezier)
+		{
+			b_spline.generate_bezier(_b_spline_degree, _b_spline_clamped, _closed);
+		}
+	}
+	
+	/** Rebuilds the cached form of any invalidated segments, or all segments if vertices were added or removed, or the type changed. */
+	private void update_segments()
+	{
+		const int count = segment_index_max + 1;
+		
+		const bool rebuild = invalidated_length_index
+			|| segments_count != count || segments_type != _type
+			|| segments_closed != _closed || segments_tension != tension;
+		
+		if(int(segments.length) < count)
+		{
+			segments.resize(count);
+		}
+		
+		segments_count = count;
+		segments_type = _type;
+		segments_closed = _closed;
+		segments_tension = tension;
+		
+		for(int i = 0; i < count; i++)
+		{
+			if(rebuild || vertices[i].invalidated)
+			{
+				build_segment(i, segments[i]);
+			}
+		}
+		
+		segments_updated = true;
+	}
+	
+	/** Selects the kernel used to evaluate the curve when calculating arcs and closest points, so that the curve type only needs to be
+	  * resolved once instead of for every sample. */
+	private void update_kernel()
+	{
+		const int count = segment_index_max + 1;
+		
+		if(vertex_count < 2)
+		{
+			@kernel = func_kernel;
+		}
+		else if(_type == CurveType::BSpline)
+		{
+			if(_b_spline_degree > 1)
+			{
+				b_spline_kernel.init(b_spline_cursor, count);
+				@kernel = b_spline_kernel;
+			}
+			else
+			{
+				@kernel = func_kernel;
+			}
+		}
+		else
+		{
+			segment_kernel.init(segments, count);
+			@kernel = segment_kernel;
+		}
+	}
+	
+	/** Resolves the control points of a single segment into `s`, applying the same fallbacks as the `eval_` methods. */
+	private void build_segment(const int i, CurveSegment@ s)
+	{
+		switch(_type)
+		{
+			case CurveType::Linear:
+			{
+				const CurveVertex@ p1 = @vertices[i];
+				const CurveVertex@ p2 = vert(i + 1);
+				s.set_linear(p1.x, p1.y, p2.x, p2.y);
+				break;
+			}
+			case CurveType::QuadraticBezier:
+			{
+				const CurveVertex@ p1 = @vertices[i];
+				const CurveControlPoint@ p2 = p1.quad_control_point;
+				const CurveVertex@ p3 = vert(i + 1);
+				
+				if(p2.type == Square)
+				{
+					s.set_linear(p1.x, p1.y, p3.x, p3.y);
+				}
+				else if(p1.weight == p2.weight && p2.weight == p3.weight)
+				{
+					s.set_quadratic(p1.x, p1.y, p1.x + p2.x, p1.y + p2.y, p3.x, p3.y);
+				}
+				else
+				{
+					s.set_quadratic(
+						p1.x, p1.y, p1.x + p2.x, p1.y + p2.y, p3.x, p3.y,
+						p1.weight, p2.weight, p3.weight);
+				}
+				break;
+			}
+			case CurveType::CubicBezier:
+			{
+				const CurveVertex@ p1 = @vertices[i];
+				const CurveVertex@ p4 = vert(i + 1);
+				const CurveControlPoint@ p2 = p1.cubic_control_point_2;
+				const CurveControlPoint@ p3 = p4.cubic_control_point_1;
+				
+				if(p2.type == Square && p3.type == Square)
+				{
+					s.set_linear(p1.x, p1.y, p4.x, p4.y);
+				}
+				else if(p2.type == Square || p3.type == Square)
+				{
+					const CurveControlPoint@ qp2 = p2.type == Square ? p4.cubic_control_point_1 : p1.cubic_control_point_2;
+					const CurveControlPoint@ p0 = p2.type == Square ? p4 : p1;
+					
+					if(p1.weight == qp2.weight && qp2.weight == p4.weight)
+					{
+						s.set_quadratic(p1.x, p1.y, p0.x + qp2.x, p0.y + qp2.y, p4.x, p4.y);
+					}
+					else
+					{
+						s.set_quadratic(
+							p1.x, p1.y, p0.x + qp2.x, p0.y + qp2.y, p4.x, p4.y,
+							p1.weight, qp2.weight, p4.weight);
+					}
+				}
+				else if(p1.weight == p2.weight && p2.weight == p3.weight && p3.weight == p4.weight)
+				{
+					s.set_cubic(p1.x, p1.y, p1.x + p2.x, p1.y + p2.y, p4.x + p3.x, p4.y + p3.y, p4.x, p4.y);
+				}
+				else
+				{
+					s.set_cubic(
+						p1.x, p1.y, p1.x + p2.x, p1.y + p2.y, p4.x + p3.x, p4.y + p3.y, p4.x, p4.y,
+						p1.weight, p2.weight, p3.weight, p4.weight);
+				}
+				break;
+			}
+			case CurveType::CatmullRom:
+			{
+				CurveVertex@ p2, p3;
+				CurveControlPoint@ p1, p4;
+				get_segment_catmull_rom(i, p1, p2, p3, p4);
+				s.set_catmull_rom(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y, tension * p2.tension);
+				break;
+			}
+			default:
+				s.set_generic();
+				break;
+		}
+	}
+	
+	/** Returns the cached form of the segment at `i`, or null if it is out of date or has no cached form. */
+	private const CurveSegment@ get_resolved_segment(const int i)
+	{
+		if(invalidated && !segments_updated || segments_type != _type || i < 0 || i >= segments_count || is_catmull_rom_segment_stale(i))
+			return null;
+		
+		const CurveSegment@ s = @segments[i];
+		if(s.kind == GenericSegment)
+			return null;
+		
+		return s;
+	}
+	
+	/** Returns the cached cubic bezier form of the Catmull-Rom segment at `i`, or null if it is out of date. */
+	private const CurveSegment@ get_catmull_rom_segment(const int i)
+	{
+		if(invalidated && !segments_updated || segments_type != CurveType::CatmullRom || i < 0 || i >= segments_count
+			|| is_catmull_rom_segment_stale(i))
+			return null;
+		
+		return @segments[i];
+	}
+	
+	/** True if the cached segment at `i` was built with a different global `tension` or Manual end control point than the current one.
+	  * These can be set directly without invalidating the curve, so are checked separately. */
+	private bool is_catmull_rom_segment_stale(const int i)
+	{
+		if(segments_type != CurveType::CatmullRom)
+			return false;
+		
+		return segments_tension != tension
+			|| (i == 0 || i == segments_count - 1) && catmull_rom_ends_moved();
+	}
+	
+	/** Starts the stepper on the given segment if it supports forward differencing.
+	  * @return False if the curve has not been validated, or the segment is rational or a b-spline, in which case `eval` must be used instead. */
+	bool start_stepper(CurveStepper@ stepper, const int segment, const int count)
+	{
+		if(invalidated && !segments_updated || segment < 0 || segment >= segments_count)
+			return false;
+		
+		return stepper.start(segments[segment], count);
+	}
+	
+	/** Returns the cached segment for the given segment and t value if it can be used, otherwise null. */
+	private const CurveSegment@ get_segment(const int segment, const float t, float &out ti)
+	{
+		if(invalidated && !segments_updated)
+			return null;
+		
+		int i;
+		calc_segment_t(segment, t, ti, i);
+		
+		if(i < 0 || i >= segments_count || is_catmull_rom_segment_stale(i))
+			return null;
+		
+		const CurveSegment@ s = @segments[i];
+		if(s.kind == GenericSegment)
+			return null;
+		
+		return s;
 	}
 	
 	/** Call to update/calculate some simple initial positions for new control points. Mostly for testing.
@@ -496,6 +1075,14 @@ class MultiCurve
 			}
 		}
 		
+		float ti;
+		const CurveSegment@ s = get_segment(segment, t, ti);
+		if(s !is null)
+		{
+			s.eval(ti, x, y, normal_x, normal_y);
+			return;
+		}
+		
 		switch(_type)
 		{
 			case CurveType::Linear:
@@ -539,6 +1126,14 @@ class MultiCurve
 			return;
 		}
 		
+		float ti;
+		const CurveSegment@ s = get_segment(segment, t, ti);
+		if(s !is null)
+		{
+			s.eval_point(ti, x, y);
+			return;
+		}
+		
 		switch(_type)
 		{
 			case CurveType::Linear:
@@ -573,6 +1168,14 @@ class MultiCurve
 			return;
 		}
 		
+		float ti;
+		const CurveSegment@ s = get_segment(segment, t, ti);
+		if(s !is null)
+		{
+			s.eval_normal(ti, normal_x, normal_y);
+			return;
+		}
+		
 		switch(_type)
 		{
 			case CurveType::Linear:
@@ -598,6 +1201,49 @@ class MultiCurve
 	}
 	
 	
+	/** Calculate the first derivative at the given segment and t value.
+	  * The derivative is always with respect to the t value within the segment, even when `segment` is negative. */
+	void eval_derivative(const int segment, const float t, float &out dx, float &out dy)
+	{
+		if(vertex_count <= 1)
+		{
+			dx = 0;
+			dy = 0;
+			return;
+		}
+		
+		float ti;
+		const CurveSegment@ s = get_segment(segment, t, ti);
+		if(s !is null)
+		{
+			s.eval_derivative(ti, dx, dy);
+			return;
+		}
+		
+		switch(_type)
+		{
+			case CurveType::Linear:
+				eval_linear_derivative(segment, t, dx, dy);
+				break;
+			case CurveType::QuadraticBezier:
+				eval_quadratic_bezier_derivative(segment, t, dx, dy);
+				break;
+			case CurveType::CubicBezier:
+				eval_cubic_bezier_derivative(segment, t, dx, dy);
+				break;
+			case CurveType::CatmullRom:
+				eval_catmull_rom_derivative(segment, t, dx, dy);
+				break;
+			case CurveType::BSpline:
+				eval_b_spline_derivative(segment, t, dx, dy);
+				break;
+			default:
+				dx = 0;
+				dy = 0;
+				break;
+		}
+	}
+		
 	/** Returns the ratio/weight at the given t value. */
 	float eval_ratio(const int segment, const float t)
 	{
@@ -626,6 +1272,219 @@ class MultiCurve
 		return 1;
 	}
 	
+	/** Calculate the position and normal at each t value in `ts`. Much faster than calling `eval` for each t value, as each segment is
+	  * only set up once for each consecutive run of t values that fall within it.
+	  * @param segment The segment index, or a negative value to treat every t value as an absolute value along the entire curve. See `eval`.
+	  * @param ts The t values to evaluate.
+	  * @param out_xy Receives the interleaved x/y position for each t value. Will be resized if it is too small.
+	  * @param out_normals Receives the interleaved x/y normal for each t value. Will be resized if it is too small.
+	  * @return The number of t values evaluated. */
+	int eval_many(const int segment, array<float>@ ts, array<float>@ out_xy, array<float>@ out_normals)
+	{
+		return eval_many_internal(segment, ts, out_xy, out_normals);
+	}
+	
+	/** Same as `eval_many` but only calculates the positions. */
+	int eval_many_point(const int segment, array<float>@ ts, array<float>@ out_xy)
+	{
+		return eval_many_internal(segment, ts, out_xy, null);
+	}
+	
+	private int eval_many_internal(const int segment, array<float>@ ts, array<float>@ out_xy, array<float>@ out_normals)
+	{
+		const int count = int(ts.length);
+		if(int(out_xy.length) < count * 2) out_xy.resize(count * 2);
+		if(out_normals !is null && int(out_normals.length) < count * 2) out_normals.resize(count * 2);
+		
+		if(vertex_count <= 1)
+		{
+			for(int i = 0; i < count; i++)
+			{
+				float x, y, normal_x, normal_y;
+				eval(segment, ts[i], x, y, normal_x, normal_y);
+				out_xy[i * 2] = x;
+				out_xy[i * 2 + 1] = y;
+				
+				if(out_normals !is null)
+				{
+					out_normals[i * 2] = normal_x;
+					out_normals[i * 2 + 1] = normal_y;
+				}
+			}
+			return count;
+		}
+		
+		if(int(eval_many_t.length) < count)
+		{
+			eval_many_t.resize(count);
+		}
+		
+		if(_type == CurveType::BSpline && b_spline_degree > 1)
+		{
+			for(int i = 0; i < count; i++)
+			{
+				eval_many_t[i] = calc_b_spline_t(segment, ts[i]);
+			}
+			
+			b_spline.eval_many(
+				b_spline_degree, b_spline_clamped, closed,
+				eval_many_t, 0, count, out_xy, out_normals);
+			return count;
+		}
+		
+		// Convert to segment t values, evaluating each run of t values within the same segment together.
+		int run_start = 0;
+		int run_segment = -1;
+		
+		for(int i = 0; i < count; i++)
+		{
+			int si;
+			float ti;
+			calc_segment_t(segment, ts[i], ti, si);
+			
+			if(si != run_segment)
+			{
+				if(i > run_start)
+				{
+					eval_many_segment(run_segment, run_start, i, out_xy, out_normals);
+				}
+				
+				run_segment = si;
+				run_start = i;
+			}
+			
+			eval_many_t[i] = ti;
+		}
+		
+		if(count > run_start)
+		{
+			eval_many_segment(run_segment, run_start, count, out_xy, out_normals);
+		}
+		
+		return count;
+	}
+	
+	/** Evaluates the t values in `eval_many_t` from `start` to `end` which all lie within segment `i`. */
+	private void eval_many_segment(const int i, const int start, const int end, array<float>@ out_xy, array<float>@ out_normals)
+	{
+		// Use the segment resolved when validating, or resolve it now if the curve has been invalidated since, so that the fallbacks
+		// are only ever resolved by `build_segment`.
+		const CurveSegment@ s = get_resolved_segment(i);
+		if(s is null)
+		{
+			build_segment(i, eval_many_segment_scratch);
+			@s = eval_many_segment_scratch;
+		}
+		
+		switch(s.kind)
+		{
+			case QuadraticSegment:
+			{
+				if(!s.rational)
+				{
+					if(out_normals !is null)
+					{
+						QuadraticBezier::eval_many(
+							s.p1x, s.p1y, s.p2x, s.p2y, s.p3x, s.p3y,
+							eval_many_t, start, end, out_xy, out_normals);
+					}
+					else
+					{
+						QuadraticBezier::eval_many_point(
+							s.p1x, s.p1y, s.p2x, s.p2y, s.p3x, s.p3y,
+							eval_many_t, start, end, out_xy);
+					}
+				}
+				else
+				{
+					if(out_normals !is null)
+					{
+						QuadraticBezier::eval_many(
+							s.p1x, s.p1y, s.p2x, s.p2y, s.p3x, s.p3y,
+							s.r1, s.r2, s.r3,
+							eval_many_t, start, end, out_xy, out_normals);
+					}
+					else
+					{
+						QuadraticBezier::eval_many_point(
+							s.p1x, s.p1y, s.p2x, s.p2y, s.p3x, s.p3y,
+							s.r1, s.r2, s.r3,
+							eval_many_t, start, end, out_xy);
+					}
+				}
+				return;
+			}
+			case CubicSegment:
+			{
+				if(!s.rational)
+				{
+					if(out_normals !is null)
+					{
+						CubicBezier::eval_many(
+							s.p1x, s.p1y, s.p2x, s.p2y, s.p3x, s.p3y, s.p4x, s.p4y,
+							eval_many_t, start, end, out_xy, out_normals);
+					}
+					else
+					{
+						CubicBezier::eval_many_point(
+							s.p1x, s.p1y, s.p2x, s.p2y, s.p3x, s.p3y, s.p4x, s.p4y,
+							eval_many_t, start, end, out_xy);
+					}
+				}
+				else
+				{
+					if(out_normals !is null)
+					{
+						CubicBezier::eval_many(
+							s.p1x, s.p1y, s.p2x, s.p2y, s.p3x, s.p3y, s.p4x, s.p4y,
+							s.r1, s.r2, s.r3, s.r4,
+							eval_many_t, start, end, out_xy, out_normals);
+					}
+					else
+					{
+						CubicBezier::eval_many_point(
+							s.p1x, s.p1y, s.p2x, s.p2y, s.p3x, s.p3y, s.p4x, s.p4y,
+							s.r1, s.r2, s.r3, s.r4,
+							eval_many_t, start, end, out_xy);
+					}
+				}
+				return;
+			}
+			case LinearSegment:
+				eval_many_linear(s.p1x, s.p1y, s.p4x, s.p4y, start, end, out_xy, out_normals);
+				return;
+		}
+		
+		// Degree 1 b-splines have no resolved form, but are the same as a linear curve.
+		const CurveVertex@ p1 = @vertices[i];
+		const CurveVertex@ p2 = vert(i + 1);
+		eval_many_linear(p1.x, p1.y, p2.x, p2.y, start, end, out_xy, out_normals);
+	}
+	
+	private void eval_many_linear(
+		const float x1, const float y1, const float x2, const float y2,
+		const int start, const int end, array<float>@ out_xy, array<float>@ out_normals)
+	{
+		const float dx = x2 - x1;
+		const float dy = y2 - y1;
+		const float length = sqrt(dx * dx + dy * dy);
+		const float normal_x = length != 0 ? dy / length : 0.0;
+		const float normal_y = length != 0 ? -dx / length : 0.0;
+		
+		for(int j = start; j < end; j++)
+		{
+			const float t = eval_many_t[j];
+			out_xy[j * 2] = x1 + dx * t;
+			out_xy[j * 2 + 1] = y1 + dy * t;
+			
+			if(out_normals !is null)
+			{
+				out_normals[j * 2] = normal_x;
+				out_normals[j * 2 + 1] = normal_y;
+			}
+		}
+	}
+	
 	void eval_linear(
 		const int segment, const float t, float &out x, float &out y, float &out normal_x, float &out normal_y)
 	{
@@ -698,6 +1557,20 @@ class MultiCurve
 		}
 	}
 	
+	void eval_linear_derivative(const int segment, const float t, float &out dx, float &out dy)
+	{
+		int i;
+		float ti;
+		calc_segment_t(segment, t, ti, i);
+		
+		// Get vertices.
+		const CurveVertex@ p1 = @vertices[i];
+		const CurveVertex@ p2 = vert(i + 1);
+		
+		dx = p2.x - p1.x;
+		dy = p2.y - p1.y;
+	}
+	
 	float eval_linear_ratio(const int segment, const float t)
 	{
 		int i;
@@ -718,6 +1591,13 @@ class MultiCurve
 		float ti;
 		calc_segment_t(segment, t, ti, i);
 		
+		const CurveSegment@ s = get_catmull_rom_segment(i);
+		if(s !is null)
+		{
+			s.eval(ti, x, y, normal_x, normal_y);
+			return;
+		}
+		
 		CurveVertex@ p2, p3;
 		CurveControlPoint@ p1, p4;
 		get_segment_catmull_rom(i, p1, p2, p3, p4);
@@ -734,30 +1614,67 @@ class MultiCurve
 		float ti;
 		calc_segment_t(segment, t, ti, i);
 		
+		const CurveSegment@ s = get_catmull_rom_segment(i);
+		if(s !is null)
+		{
+			s.eval_point(ti, x, y);
+			return;
+		}
+		
+		CurveVertex@ p2, p3;
+		CurveControlPoint@ p1, p4;
+		get_segment_catmull_rom(i, p1, p2, p3, p4);
+		
+		CatmullRom::eval_point(
+			p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y,
+			tension * p2.tension,
+			ti, x, y);
+	}
+	
+	void eval_catmull_rom_normal(const int segment, const float t, float &out normal_x, float &out normal_y)
+	{
+		int i;
+		float ti;
+		calc_segment_t(segment, t, ti, i);
+		
+		const CurveSegment@ s = get_catmull_rom_segment(i);
+		if(s !is null)
+		{
+			s.eval_normal(ti, normal_x, normal_y);
+			return;
+		}
+		
 		CurveVertex@ p2, p3;
 		CurveControlPoint@ p1, p4;
 		get_segment_catmull_rom(i, p1, p2, p3, p4);
 		
-		CatmullRom::eval_point(
+		CatmullRom::eval_normal(
 			p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y,
 			tension * p2.tension,
-			ti, x, y);
+			ti, normal_x, normal_y);
 	}
 	
-	void eval_catmull_rom_normal(const int segment, const float t, float &out normal_x, float &out normal_y)
+	void eval_catmull_rom_derivative(const int segment, const float t, float &out dx, float &out dy)
 	{
 		int i;
 		float ti;
 		calc_segment_t(segment, t, ti, i);
 		
+		const CurveSegment@ s = get_catmull_rom_segment(i);
+		if(s !is null)
+		{
+			s.eval_derivative(ti, dx, dy);
+			return;
+		}
+		
 		CurveVertex@ p2, p3;
 		CurveControlPoint@ p1, p4;
 		get_segment_catmull_rom(i, p1, p2, p3, p4);
 		
-		CatmullRom::eval_normal(
+		CatmullRom::eval_derivative(
 			p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y,
 			tension * p2.tension,
-			ti, normal_x, normal_y);
+			ti, dx, dy);
 	}
 	
 	float eval_catmull_rom_ratio(const int segment, const float t)
@@ -878,6 +1795,41 @@ class MultiCurve
 		}
 	}
 	
+	void eval_quadratic_bezier_derivative(const int segment, const float t, float &out dx, float &out dy)
+	{
+		int i;
+		float ti;
+		calc_segment_t(segment, t, ti, i);
+		
+		// Get vertices.
+		const CurveVertex@ p1 = @vertices[i];
+		const CurveVertex@ p3 = vert(i + 1);
+		const CurveControlPoint@ p2 = p1.quad_control_point;
+		
+		// Linear fallback.
+		if(p2.type == Square)
+		{
+			eval_linear_derivative(segment, t, dx, dy);
+			return;
+		}
+		
+		// Non-rational.
+		if(p1.weight == p2.weight && p2.weight == p3.weight)
+		{
+			QuadraticBezier::eval_derivative(
+				p1.x, p1.y, p1.x + p2.x, p1.y + p2.y, p3.x, p3.y,
+				ti, dx, dy);
+		}
+		// Rational.
+		else
+		{
+			QuadraticBezier::eval_derivative(
+				p1.x, p1.y, p1.x + p2.x, p1.y + p2.y, p3.x, p3.y,
+				p1.weight, p2.weight, p3.weight,
+				ti, dx, dy);
+		}
+	}
+	
 	float eval_quadratic_bezier_ratio(const int segment, const float t)
 	{
 		int i;
@@ -1081,6 +2033,65 @@ class MultiCurve
 		}
 	}
 	
+	void eval_cubic_bezier_derivative(const int segment, const float t, float &out dx, float &out dy)
+	{
+		int i;
+		float ti;
+		calc_segment_t(segment, t, ti, i);
+		
+		const CurveVertex@ p1 = @vertices[i];
+		const CurveVertex@ p4 = vert(i + 1);
+		const CurveControlPoint@ p2 = p1.cubic_control_point_2;
+		const CurveControlPoint@ p3 = p4.cubic_control_point_1;
+		
+		// Linear fallback.
+		if(p2.type == Square && p3.type == Square)
+		{
+			eval_linear_derivative(segment, t, dx, dy);
+			return;
+		}
+		
+		// Quadratic fallback.
+		if(p2.type == Square || p3.type == Square)
+		{
+			const CurveControlPoint@ qp2 = p2.type == Square ? p4.cubic_control_point_1 : p1.cubic_control_point_2;
+			const CurveControlPoint@ p0 = p2.type == Square ? p4 : p1;
+			
+			// Non-rational.
+			if(p1.weight == qp2.weight && qp2.weight == p4.weight)
+			{
+				QuadraticBezier::eval_derivative(
+					p1.x, p1.y, p0.x + qp2.x, p0.y + qp2.y, p4.x, p4.y,
+					ti, dx, dy);
+			}
+			// Rational.
+			else
+			{
+				QuadraticBezier::eval_derivative(
+					p1.x, p1.y, p0.x + qp2.x, p0.y + qp2.y, p4.x, p4.y,
+					p1.weight, qp2.weight, p4.weight,
+					ti, dx, dy);
+			}
+			return;
+		}
+		
+		// Non-rational.
+		if(p1.weight == p2.weight && p2.weight == p3.weight && p3.weight == p4.weight)
+		{
+			CubicBezier::eval_derivative(
+				p1.x, p1.y, p1.x + p2.x, p1.y + p2.y, p4.x + p3.x, p4.y + p3.y, p4.x, p4.y,
+				ti, dx, dy);
+		}
+		// Rational.
+		else
+		{
+			CubicBezier::eval_derivative(
+				p1.x, p1.y, p1.x + p2.x, p1.y + p2.y, p4.x + p3.x, p4.y + p3.y, p4.x, p4.y,
+				p1.weight, p2.weight, p3.weight, p4.weight,
+				ti, dx, dy);
+		}
+	}
+	
 	float eval_cubic_bezier_ratio(const int segment, const float t)
 	{
 		int i;
@@ -1134,6 +2145,12 @@ class MultiCurve
 		}
 		
 		const float ta = calc_b_spline_t(segment, t);
+		if(!invalidated_b_spline_knots)
+		{
+			b_spline_cursor.eval(ta, x, y, normal_x, normal_y);
+			return;
+		}
+		
 		b_spline.eval(
 			b_spline_degree, b_spline_clamped, closed, 
 			ta, x, y, normal_x, normal_y);
@@ -1150,6 +2167,12 @@ class MultiCurve
 		const float ta = segment >= 0
 			? (segment + (t > 0 ? t : t < 1 ? t : 1)) / (_closed ? vertex_count : vertex_count - 1)
 			: t;
+		if(!invalidated_b_spline_knots)
+		{
+			b_spline_cursor.eval_point(ta, x, y);
+			return;
+		}
+		
 		b_spline.eval_point(
 			b_spline_degree, b_spline_clamped, closed, 
 			ta, x, y);
@@ -1166,11 +2189,43 @@ class MultiCurve
 		const float ta = segment >= 0
 			? (segment + (t > 0 ? t : t < 1 ? t : 1)) / (_closed ? vertex_count : vertex_count - 1)
 			: t;
+		if(!invalidated_b_spline_knots)
+		{
+			b_spline_cursor.eval_normal(ta, normal_x, normal_y);
+			return;
+		}
+		
 		b_spline.eval_normal(
 			b_spline_degree, b_spline_clamped, closed, 
 			ta, normal_x, normal_y);
 	}
 	
+	void eval_b_spline_derivative(const int segment, const float t, float &out dx, float &out dy)
+	{
+		if(b_spline_degree <= 1)
+		{
+			eval_linear_derivative(segment, t, dx, dy);
+			return;
+		}
+		
+		const float ta = calc_b_spline_t(segment, t);
+		if(!invalidated_b_spline_knots)
+		{
+			b_spline_cursor.eval_derivative(ta, dx, dy);
+		}
+		else
+		{
+			b_spline.eval_derivative(
+				b_spline_degree, b_spline_clamped, closed, 
+				ta, dx, dy);
+		}
+		
+		// The b-spline t value spans the entire curve, so scale it back to a single segment.
+		const float segment_count = _closed ? vertex_count : vertex_count - 1;
+		dx /= segment_count;
+		dy /= segment_count;
+	}
+	
 	float eval_b_spline_ratio(const int segment, const float t)
 	{
 		if(b_spline_degree <= 1)
@@ -1184,23 +2239,352 @@ class MultiCurve
 	
 	// --
 	
+	/** Finds the segments whose bounding box overlaps the given rectangle.
+	  * @param out_segments Receives the segment indices in ascending order. Resized if needed.
+	  * @return The number of segments found. */
+	int query_segments(const float x1, const float y1, const float x2, const float y2, array<int>@ out_segments)
+	{
+		validate();
+		return _segment_bvh.query_rect(x1, y1, x2, y2, out_segments);
+	}
+	
 	/** See `Curve::closest_point`. */
 	bool closest_point(
 		const float x, const float y, int &out segment_index, float &out t, float &out px, float &out py,
 		const float max_distance=0, float threshold=1,
 		const bool arc_length_interpolation=true,
 		const bool adjust_initial_binary_factor=true,
-		const bool interpolate_result=true)
+		const bool interpolate_result=true,
+		const bool newton=false)
 	{
+		closest_point_stats.reset();
+		
+		if(max_distance > 0)
+		{
+			validate_arcs(x - max_distance, y - max_distance, x + max_distance, y + max_distance);
+		}
+		else
+		{
+			validate_arcs();
+		}
+		
+		// The grid is only built once the curve is next validated after being enabled.
+		CurveArcGrid@ grid = null;
+		if(subdivision_settings.arc_grid && arc_grid.cols > 0)
+		{
+			@grid = arc_grid;
+		}
+		
+		// Without a grid, the segment bounding volume hierarchy can still skip segments that are out of range.
+		array<int>@ candidates = null;
+		int candidate_count = 0;
+		if(@grid == null && max_distance > 0)
+		{
+			candidate_count = _segment_bvh.query_rect(
+				x - max_distance, y - max_distance, x + max_distance, y + max_distance,
+				bvh_segments);
+			@candidates = bvh_segments;
+		}
+		
 		return Curve::closest_point(
-			vertices, vertex_count, closed,
-			eval_point_func_def,
+			vertices, vertex_count, closed, _arcs,
+			kernel,
 			x, y, segment_index, t, px, py,
 			max_distance, threshold,
 			arc_length_interpolation,
 			adjust_initial_binary_factor,
 			interpolate_result,
-			x1, y1, x2, y2);
+			x1, y1, x2, y2,
+			grid, candidates, candidate_count,
+			newton, closest_point_stats,
+			heap_dist, heap_segment);
+	}
+	
+	/** Same as `closest_point`, but starts from the result of the previous query stored in `state`, and updates it with the new result.
+	  * If the point, settings, and curve `version` are the same as the last query, the previous result is returned without searching.
+	  * Otherwise the segment of the previous closest point and its neighbours are searched first. The rest of the curve is only searched
+	  * if the bounding box of another segment is closer than the point found, and then only those segments are searched.
+	  * This is much cheaper than `closest_point` when the point only moves a small amount between queries, e.g. when following the mouse. */
+	bool closest_point_warm(
+		CurveClosestPoint@ state,
+		const float x, const float y, int &out segment_index, float &out t, float &out px, float &out py,
+		const float max_distance=0, float threshold=1,
+		const bool arc_length_interpolation=true,
+		const bool adjust_initial_binary_factor=true,
+		const bool interpolate_result=true,
+		const bool newton=false)
+	{
+		closest_point_stats.reset();
+		
+		if(max_distance > 0)
+		{
+			validate_arcs(x - max_distance, y - max_distance, x + max_distance, y + max_distance);
+		}
+		else
+		{
+			validate_arcs();
+		}
+		
+		if(state.version == _version && state.x == x && state.y == y &&
+			state.max_distance == max_distance && state.threshold == threshold &&
+			state.arc_length_interpolation == arc_length_interpolation &&
+			state.adjust_initial_binary_factor == adjust_initial_binary_factor &&
+			state.interpolate_result == interpolate_result && state.newton == newton)
+		{
+			segment_index = state.segment;
+			t = state.t;
+			px = state.px;
+			py = state.py;
+			return state.found;
+		}
+		
+		const int end = segment_index_max;
+		bool found = false;
+		
+		if(state.version == -1 || state.segment < 0 || state.segment > end)
+		{
+			found = closest_point(
+				x, y, segment_index, t, px, py,
+				max_distance, threshold,
+				arc_length_interpolation,
+				adjust_initial_binary_factor,
+				interpolate_result,
+				newton);
+		}
+		else
+		{
+			// -- Search the previous closest segment and its neighbours.
+			
+			if(int(warm_segments.length) < 3)
+			{
+				warm_segments.resize(3);
+			}
+			
+			int local_count = 0;
+			for(int i = state.segment - 1; i <= state.segment + 1; i++)
+			{
+				if(!_closed && (i < 0 || i > end))
+					continue;
+				
+				const int si = (i % (end + 1) + end + 1) % (end + 1);
+				if((local_count > 0 && warm_segments[local_count - 1] == si) || (local_count > 1 && warm_segments[0] == si))
+					continue;
+				
+				warm_segments[local_count++] = si;
+			}
+			
+			warm_segments.sortAsc(0, local_count);
+			
+			found = Curve::closest_point(
+				vertices, vertex_count, closed, _arcs,
+				kernel,
+				x, y, segment_index, t, px, py,
+				max_distance, threshold,
+				arc_length_interpolation,
+				adjust_initial_binary_factor,
+				interpolate_result,
+				x1, y1, x2, y2,
+				null, warm_segments, local_count,
+				newton, closest_point_stats,
+				heap_dist, heap_segment);
+			
+			// -- Find any other segments that could contain a closer point.
+			
+			float bound_sqr = max_distance > 0 ? max_distance * max_distance : INFINITY;
+			if(found)
+			{
+				bound_sqr = (x - px) * (x - px) + (y - py) * (y - py);
+			}
+			
+			int candidate_count = 0;
+			bool any_other = false;
+			int bvh_segment;
+			float bvh_dist_sqr;
+			
+			// Every arc of a segment lies within its bounding box, so segments whose box is farther away than the local result can be ignored.
+			_segment_bvh.nearest_start(x, y);
+			while(_segment_bvh.nearest_next(bvh_segment, bvh_dist_sqr) && bvh_dist_sqr < bound_sqr)
+			{
+				if(candidate_count >= int(bvh_segments.length))
+				{
+					bvh_segments.resize(max(candidate_count * 2, 16));
+				}
+				
+				bvh_segments[candidate_count++] = bvh_segment;
+				
+				if(!any_other)
+				{
+					any_other = true;
+					for(int i = 0; i < local_count; i++)
+					{
+						if(warm_segments[i] == bvh_segment)
+						{
+							any_other = false;
+							break;
+						}
+					}
+				}
+			}
+			
+			if(any_other)
+			{
+				bvh_segments.sortAsc(0, candidate_count);
+				
+				found = Curve::closest_point(
+					vertices, vertex_count, closed, _arcs,
+					kernel,
+					x, y, segment_index, t, px, py,
+					max_distance, threshold,
+					arc_length_interpolation,
+					adjust_initial_binary_factor,
+					interpolate_result,
+					x1, y1, x2, y2,
+					null, bvh_segments, candidate_count,
+					newton, closest_point_stats,
+					heap_dist, heap_segment);
+			}
+		}
+		
+		state.found = found;
+		state.x = x;
+		state.y = y;
+		state.segment = found ? segment_index : -1;
+		state.t = t;
+		state.px = px;
+		state.py = py;
+		state.version = _version;
+		state.max_distance = max_distance;
+		state.threshold = threshold;
+		state.arc_length_interpolation = arc_length_interpolation;
+		state.adjust_initial_binary_factor = adjust_initial_binary_factor;
+		state.interpolate_result = interpolate_result;
+		state.newton = newton;
+		
+		return found;
+	}
+	
+	/** Finds the closest point to each of the given points. Much faster than calling `closest_point` for each point.
+	  * See `Curve::closest_points`. */
+	int closest_points(
+		const array<float>@ xs, const array<float>@ ys, const int count,
+		array<int>@ segments, array<float>@ ts, array<float>@ pxs, array<float>@ pys,
+		const float max_distance=0, const float threshold=1,
+		const bool adjust_initial_binary_factor=true,
+		const bool interpolate_result=true,
+		const bool newton=false)
+	{
+		closest_point_stats.reset();
+		
+		if(max_distance > 0 && lazy_arcs)
+		{
+			// Only the arcs near the points are needed.
+			float px1 = INFINITY, py1 = INFINITY, px2 = -INFINITY, py2 = -INFINITY;
+			for(int i = 0; i < count; i++)
+			{
+				px1 = min(px1, xs[i]);
+				py1 = min(py1, ys[i]);
+				px2 = max(px2, xs[i]);
+				py2 = max(py2, ys[i]);
+			}
+			
+			validate_arcs(px1 - max_distance, py1 - max_distance, px2 + max_distance, py2 + max_distance);
+		}
+		else
+		{
+			validate_arcs();
+		}
+		
+		return Curve::closest_points(
+			vertices, vertex_count, closed, _arcs,
+			kernel, _segment_bvh,
+			xs, ys, count,
+			segments, ts, pxs, pys,
+			max_distance, threshold,
+			adjust_initial_binary_factor,
+			interpolate_result,
+			newton,
+			closest_point_stats,
+			closest_points_scratch);
+	}
+	
+	/** Finds every point on the curve within `radius` of the given point that is closer than the points around it, e.g. each place a
+	  * circle touches the curve. See `Curve::points_within`.
+	  * @param out_points Receives the points in order along the curve. Resized if needed.
+	  * @return The number of points found. */
+	int points_within(
+		const float x, const float y, const float radius, array<CurveSegmentPoint>@ out_points,
+		const float threshold=1,
+		const bool adjust_initial_binary_factor=true,
+		const bool interpolate_result=true,
+		const bool newton=false)
+	{
+		closest_point_stats.reset();
+		
+		validate_arcs(x - radius, y - radius, x + radius, y + radius);
+		
+		const int candidate_count = _segment_bvh.query_rect(x - radius, y - radius, x + radius, y + radius, bvh_segments);
+		
+		return Curve::points_within(
+			vertices, vertex_count, closed, _arcs,
+			kernel,
+			x, y, radius, out_points,
+			bvh_segments, candidate_count,
+			threshold,
+			adjust_initial_binary_factor,
+			interpolate_result,
+			newton,
+			closest_point_stats);
+	}
+	
+	// -- Mapping methods --
+	
+	/** Converts a distance along the curve to a segment index and t value. The curve must be validated.
+	  * See `Curve::distance_to_t`. */
+	void distance_to_t(const float distance, int &out segment, float &out t)
+	{
+		validate_arcs();
+		
+		Curve::distance_to_t(
+			vertices, vertex_count, _closed, _arcs,
+			distance, segment, t,
+			length_index, _distance_fit);
+	}
+	
+	/** Converts a segment index and t value to a distance along the curve. The curve must be validated.
+	  * @param segment The segment index. Passing a negative value will treat `t` as an absolute value along the entire curve, the same as `eval`.
+	  * See `Curve::t_to_distance`. */
+	float t_to_distance(const int segment, const float t)
+	{
+		if(vertex_count <= 1)
+			return 0;
+		
+		validate_arcs();
+		
+		int i;
+		float ti;
+		calc_segment_t(segment, t, ti, i);
+		
+		return Curve::t_to_distance(
+			vertices, vertex_count, _closed, _arcs,
+			i, ti,
+			length_index);
+	}
+	
+	/** Places points at regular distances along the curve. The curve must be validated.
+	  * See `Curve::sample_uniform`.
+	  * @return The number of samples written to the output arrays. */
+	int sample_uniform(
+		const float spacing, const float offset,
+		array<float>@ out_x, array<float>@ out_y, array<float>@ out_nx, array<float>@ out_ny,
+		const bool eval_curve=true)
+	{
+		validate_arcs();
+		
+		return Curve::sample_uniform(
+			vertices, vertex_count, _closed, _arcs,
+			eval_func_def, spacing, offset,
+			out_x, out_y, out_nx, out_ny,
+			eval_curve);
 	}
 	
 	// -- Modification methods --
@@ -1209,11 +2593,18 @@ class MultiCurve
 	{
 		vertices.resize(0);
 		vertex_count = 0;
+		_arcs.clear();
+		_distance_fit.clear();
+		arc_grid.clear();
+		_segment_bvh.clear();
+		arcs_pending = false;
 		
 		control_point_start.type = None;
 		control_point_end.type = None;
 		
 		invalidated = true;
+		invalidated_length_index = true;
+		invalidated_segment_bvh = true;
 		invalidated_b_spline_knots = true;
 		invalidated_b_spline_vertices = true;
 		invalidated_control_points = true;
@@ -1227,6 +2618,8 @@ class MultiCurve
 		v.y = y;
 		
 		invalidated = true;
+		invalidated_length_index = true;
+		invalidated_segment_bvh = true;
 		invalidated_b_spline_knots = true;
 		invalidated_b_spline_vertices = true;
 		invalidated_control_points = true;
@@ -1247,6 +2640,8 @@ class MultiCurve
 		vertex_count--;
 		
 		invalidate(i);
+		invalidated_length_index = true;
+		invalidated_segment_bvh = true;
 		invalidated_b_spline_knots = true;
 		invalidated_b_spline_vertices = true;
 		
@@ -1280,6 +2675,9 @@ class MultiCurve
 		p.x = x;
 		p.y = y;
 		
+		invalidated_length_index = true;
+		invalidated_segment_bvh = true;
+		
 		if(_type == CurveType::BSpline)
 		{
 			invalidated_b_spline_knots = true;
@@ -1514,6 +2912,8 @@ class MultiCurve
 		const int new_index = b_spline.insert_vertex_linear(b_spline_degree, b_spline_clamped, closed, segment, t);
 		vertex_count++;
 		
+		invalidated_length_index = true;
+		invalidated_segment_bvh = true;
 		invalidated_b_spline_knots = true;
 		invalidated_b_spline_vertices = true;
 		invalidate(new_index);
@@ -1849,21 +3249,79 @@ class MultiCurve
 		@p1 = p2.type != Square
 			? closed || i > 0
 				? vert(i - 1)
-				: _end_controls != Manual
-					? this.p0.extrapolate(p2, p3,
-						_end_controls == CurveEndControl::AutomaticAngle && vertex_count >= 3 ? @vertices[2] : null)
-					: this.p0.added(p2, check_control_point_start())
+				: get_catmull_rom_start()
 			: p2;
 		@p4 = p3.type != Square
 			? closed || i < vertex_count - 2
 				? vert(i + 2)
-				: _end_controls != Manual
-					? this.p3.extrapolate(p3, p2,
-						_end_controls == CurveEndControl::AutomaticAngle && vertex_count >= 3 ? @vertices[vertex_count - 3] : null)
-					: this.p3.added(p3, check_control_point_end())
+				: get_catmull_rom_end()
 			: p3;
 	}
 	
+	/** Returns the control point before the first vertex of an open Catmull-Rom curve, only recalculating it if the curve has changed
+	  * since it was last validated. */
+	private CurveVertex@ get_catmull_rom_start()
+	{
+		if(catmull_rom_ends_cached && (!invalidated || catmull_rom_ends_updated) && !catmull_rom_ends_moved())
+			return p0;
+		
+		return _end_controls != Manual
+			? p0.extrapolate(vertices[0], vertices[1],
+				_end_controls == CurveEndControl::AutomaticAngle && vertex_count >= 3 ? @vertices[2] : null)
+			: p0.added(vertices[0], check_control_point_start());
+	}
+	
+	/** Returns the control point after the last vertex of an open Catmull-Rom curve. See `get_catmull_rom_start`. */
+	private CurveVertex@ get_catmull_rom_end()
+	{
+		if(catmull_rom_ends_cached && (!invalidated || catmull_rom_ends_updated) && !catmull_rom_ends_moved())
+			return p3;
+		
+		return _end_controls != Manual
+			? p3.extrapolate(vertices[vertex_count - 1], vertices[vertex_count - 2],
+				_end_controls == CurveEndControl::AutomaticAngle && vertex_count >= 3 ? @vertices[vertex_count - 3] : null)
+			: p3.added(vertices[vertex_count - 1], check_control_point_end());
+	}
+	
+	/** Resolves and caches the end control points of open Catmull-Rom curves, which would otherwise be recalculated every time the first
+	  * or last segment is evaluated. */
+	private void update_catmull_rom_ends()
+	{
+		catmull_rom_ends_cached = false;
+		catmull_rom_ends_updated = false;
+		
+		if(_type != CurveType::CatmullRom || _closed || vertex_count < 2)
+			return;
+		
+		get_catmull_rom_start();
+		get_catmull_rom_end();
+		catmull_rom_start_x = control_point_start.x;
+		catmull_rom_start_y = control_point_start.y;
+		catmull_rom_end_x = control_point_end.x;
+		catmull_rom_end_y = control_point_end.y;
+		catmull_rom_ends_cached = true;
+		catmull_rom_ends_updated = true;
+	}
+	
+	/** True if a Manual end control point has been moved since the end control points were cached. */
+	private bool catmull_rom_ends_moved()
+	{
+		return catmull_rom_ends_cached && _end_controls == Manual && (
+			control_point_start.x != catmull_rom_start_x || control_point_start.y != catmull_rom_start_y ||
+			control_point_end.x != catmull_rom_end_x || control_point_end.y != catmull_rom_end_y);
+	}
+	
+	/** Invalidates the first and last segments of an open Catmull-Rom curve, which depend on the end control points. */
+	private void invalidate_catmull_rom_ends()
+	{
+		if(_type != CurveType::CatmullRom || _closed || vertex_count < 2)
+			return;
+		
+		invalidated = true;
+		vertices[0].invalidated = true;
+		vertices[segment_index_max].invalidated = true;
+	}
+	
 	CurveVertex@ get_auto_control_start(CurveVertex@ p_out, const CurveEndControl type)
 	{
 		if(vertex_count == 0)
@@ -1976,23 +3434,14 @@ class MultiCurve
 		const int end = segment_index_max;
 		for(int i = 0; i <= end; i++)
 		{
-			CurveVertex@ p2, p3;
-			CurveControlPoint@ p1, p4;
-			get_segment_catmull_rom(i, p1, p2, p3, p4);
+			CurveVertex@ p2 = @vertices[i];
 			
 			if(p2.invalidated)
 			{
-				float bp1x, bp1y, bp2x, bp2y, bp3x, bp3y, bp4x, bp4y;
-				CatmullRom::to_cubic_bezier(
-					p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y, tension * p2.tension,
-					bp1x, bp1y, bp2x, bp2y, bp3x, bp3y, bp4x, bp4y);
-				bp2x += p2.x;
-				bp2y += p2.y;
-				bp3x += p3.x;
-				bp3y += p3.y;
-				
+				// The segments are always rebuilt before the bounding box, so the cubic bezier form can be used directly.
+				const CurveSegment@ s = @segments[i];
 				CubicBezier::bounding_box(
-					bp1x, bp1y, bp2x, bp2y, bp3x, bp3y, bp4x, bp4y,
+					s.p1x, s.p1y, s.p2x, s.p2y, s.p3x, s.p3y, s.p4x, s.p4y,
 					p2.x1, p2.y1, p2.x2, p2.y2);
 			}
 			
@@ -2120,9 +3569,18 @@ class MultiCurve
 	
 	private void calc_bounding_box_b_spline()
 	{
-		b_spline.bounding_box_basic(
-			vertex_count, _b_spline_degree, _closed,
-			x1, y1, x2, y2);
+		if(b_spline_bezier && _b_spline_degree > 1)
+		{
+			b_spline.bounding_box_bezier(
+				vertex_count, _b_spline_degree, _b_spline_clamped, _closed,
+				x1, y1, x2, y2);
+		}
+		else
+		{
+			b_spline.bounding_box_basic(
+				vertex_count, _b_spline_degree, _b_spline_clamped, _closed,
+				x1, y1, x2, y2);
+		}
 	}
 	
 	// -- Util --
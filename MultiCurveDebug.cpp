@@ -65,6 +65,11 @@ class MultiCurveDebug
 	private CurveVertex p0;
 	private CurveVertex p3;
 	
+	private CurveStepper stepper;
+	
+	/** The segments overlapping the clip bounds, found with `MultiCurve::query_segments`. */
+	private array<int> clip_segments;
+	
 	private float _clip_x1, _clip_y1;
 	private float _clip_x2, _clip_y2;
 	
@@ -306,15 +311,13 @@ class MultiCurveDebug
 		const bool eval_normal = draw_curve && draw_normal || draw_normal || adaptive_angle > 0;
 		const int subdivisions = curve.type != CurveType::Linear && adaptive_angle > 0 ? adaptive_max_subdivisions : 0;
 		
-		for(int i = 0; i <= v_count; i++)
+		const int segment_count = clip
+			? curve.query_segments(_clip_x1, _clip_y1, _clip_x2, _clip_y2, clip_segments)
+			: v_count + 1;
+		
+		for(int si = 0; si < segment_count; si++)
 		{
-			if(clip)
-			{
-				CurveVertex@ v = curve.vertices[i];
-				
-				if(clip && (v.x1 > _clip_x2 || v.x2 < _clip_x1 || v.y1 > _clip_y2 || v.y2 < _clip_y1))
-					continue;
-			}
+			const int i = clip ? clip_segments[si] : si;
 			
 			float t1 = 0;
 			float x1 = 0;
@@ -322,19 +325,34 @@ class MultiCurveDebug
 			float n1x = 0;
 			float n1y = 0;
 			
+			stepper.calculate_normals = eval_normal;
+			const bool stepping = curve.start_stepper(stepper, i, count);
+			
 			for(int j = 0; j <= count; j++)
 			{
 				const float t2 = float(j) / count;
 				
 				float x2, y2, n2x, n2y;
 				
+				// A zero normal will cause `draw_segment` to evaluate the curve instead.
+				float sx = 0, sy = 0, snx = 0, sny = 0;
+				if(stepping)
+				{
+					sx = stepper.x;
+					sy = stepper.y;
+					snx = eval_normal ? stepper.normal_x : 1.0;
+					sny = eval_normal ? stepper.normal_y : 0.0;
+					stepper.step();
+				}
+				
 				draw_segment(
 					c, curve, zoom_factor,
 					i, v_count,
 					t1, t2, t2, x1, y1, n1x, n1y,
 					j > 0, draw_curve, draw_normal, eval_normal,
 					adaptive_angle, subdivisions,
-					x2, y2, n2x, n2y);
+					x2, y2, n2x, n2y,
+					sx, sy, snx, sny);
 				
 				t1 = t2;
 				x1 = x2;
@@ -666,48 +684,62 @@ class MultiCurveDebug
 		if(!check_clip(curve, max(line_width, nl)))
 			return;
 		
+		if(clip)
+		{
+			curve.validate_arcs(_clip_x1, _clip_y1, _clip_x2, _clip_y2);
+		}
+		else
+		{
+			curve.validate_arcs();
+		}
+		
 		const int v_count = curve.closed ? curve.vertex_count - 1 : curve.vertex_count - 2;
 		const bool draw_normal = normal_width > 0 && normal_length > 0;
+		CurveArcs@ arcs = curve.arcs;
 		
-		for(int i = 0; i <= v_count; i++)
+		const int segment_count = clip
+			? curve.query_segments(_clip_x1, _clip_y1, _clip_x2, _clip_y2, clip_segments)
+			: v_count + 1;
+		
+		for(int si = 0; si < segment_count; si++)
 		{
+			const int i = clip ? clip_segments[si] : si;
 			CurveVertex@ v = curve.vertices[i];
-			array<CurveArc>@ arcs = @v.arcs;
+			const int o = v.arc_offset;
 			int arc_count = v.arc_count;
 			
 			if(arc_count <= 0)
 				continue;
 			
-			if(clip && (v.x1 > _clip_x2 || v.x2 < _clip_x1 || v.y1 > _clip_y2 || v.y2 < _clip_y1))
-				continue;
-			
-			float x1 = arcs[0].x;
-			float y1 = arcs[0].y;
-			for(int j = 1; j < arc_count; j++)
+			float x1 = arcs.x[o];
+			float y1 = arcs.y[o];
+			for(int j = o + 1; j < o + arc_count; j++)
 			{
-				CurveArc@ arc = @arcs[j];
+				const float x2 = arcs.x[j];
+				const float y2 = arcs.y[j];
 				
 				const uint clr = @segment_colour_callback != null
-					? segment_colour_callback.get_curve_line_colour(curve, i, v_count, arc.t)
+					? segment_colour_callback.get_curve_line_colour(curve, i, v_count, arcs.t[j])
 					: line_clr;
-				c.draw_line(x1, y1, arc.x, arc.y, lw, clr);
+				c.draw_line(x1, y1, x2, y2, lw, clr);
 				
-				x1 = arc.x;
-				y1 = arc.y;
+				x1 = x2;
+				y1 = y2;
 			}
 			
 			if(draw_normal)
 			{
-				for(int j = 1; j < arc_count; j++)
+				for(int j = o + 1; j < o + arc_count; j++)
 				{
-					CurveArc@ arc = @arcs[j];
+					const float x = arcs.x[j];
+					const float y = arcs.y[j];
+					const float nx = arcs.nx[j] * nl;
+					const float ny = arcs.ny[j] * nl;
 					
 					const uint clr = @segment_colour_callback != null
-						? segment_colour_callback.get_curve_line_colour(curve, i, v_count, arc.t)
+						? segment_colour_callback.get_curve_line_colour(curve, i, v_count, arcs.t[j])
 						: line_clr;
-					c.draw_line(
-						arc.x - arc.nx * nl, arc.y - arc.ny * nl, arc.x + arc.nx * nl, arc.y + arc.ny * nl, normal_width * zoom_factor,
-						clr);
+					c.draw_line(x - nx, y - ny, x + nx, y + ny, normal_width * zoom_factor, clr);
 				}
 			}
 		}
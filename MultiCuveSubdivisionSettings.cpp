@@ -2,7 +2,10 @@
 class MultiCuveSubdivisionSettings
 {
 	
-	/** `division_count` */
+	/** How the arcs and length are calculated. The remaining properties only apply to the `Subdivision` mode unless otherwise stated. */
+	CurveLengthMode mode = Subdivision;
+	
+	/** `division_count`. Also used by `Quadrature`. */
 	int count = 6;
 	
 	/** Specified in degrees. */
@@ -19,4 +22,30 @@ class MultiCuveSubdivisionSettings
 	
 	float length_max = 0;
 	
+	/** `Quadrature` only. See `Curve::calculate_arc_lengths_quadrature`. */
+	float quadrature_tolerance = 0.05;
+	
+	/** `Quadrature` only. See `Curve::calculate_arc_lengths_quadrature`. */
+	int quadrature_max_depth = 6;
+	
+	/** `Tolerance` only. See `Curve::calculate_arc_lengths_tolerance`. */
+	float tolerance = 0.5;
+	
+	/** `Tolerance` only. See `Curve::calculate_arc_lengths_tolerance`. */
+	int tolerance_max_subdivisions = 10;
+	
+	/** If > 0, fits a polynomial with this many coefficients to the inverse arc length of each segment when the curve is validated,
+	  * allowing `MultiCurve::distance_to_t` to skip searching the arcs. See `CurveDistanceFit`. */
+	int distance_fit_order = 0;
+	
+	/** The maximum error in world units allowed when fitting a segment. Segments exceeding it will fall back to searching the arcs. */
+	float distance_fit_tolerance = 0.5;
+	
+	/** If true, maintains a uniform grid of the arcs when the curve is validated, allowing `MultiCurve::closest_point` to only test the arcs
+	  * near the given point, instead of every arc. Mostly useful for long curves with many segments. See `CurveArcGrid`. */
+	bool arc_grid = false;
+	
+	/** The size of each grid cell. If <= 0 it is based on the average arc length. */
+	float arc_grid_cell_size = 0;
+	
 }
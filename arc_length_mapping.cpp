@@ -0,0 +1,253 @@
+namespace Curve
+{
+	
+	/** Converts a distance along a curve to a segment index and t value using the precomputed arcs from `calculate_arc_lengths`.
+	  * The segment is found using `length_index` if provided, and then a binary search over the arcs within that segment, and the
+	  * t value is linearly interpolated within the closest arc.
+	  * @param vertices The vertices defining a curve made up of multiple segments.
+	  * @param vertex_count The number of vertices.
+	  * @param closed Is the curve closed or open.
+	  * @param arcs The arcs calculated by `calculate_arc_lengths`.
+	  * @param distance The distance from the start of the curve. Will be clamped between 0 and the length of the curve.
+	  * @param segment_index The index of the segment containing the given distance.
+	  * @param out_t The t value within `segment_index`.
+	  * @param length_index If provided is used to find the segment in O(log n), otherwise the segment lengths are summed until
+	  *   the distance is reached.
+	  * @param distance_fit If provided, the t value is calculated from the fitted polynomial instead of searching the arcs, unless the
+	  *   segment could not be fitted. */
+	void distance_to_t(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed, CurveArcs@ arcs,
+		const float distance, int &out segment_index, float &out out_t,
+		CurveLengthIndex@ length_index=null, CurveDistanceFit@ distance_fit=null)
+	{
+		segment_index = 0;
+		out_t = 0;
+		
+		const int end = closed ? vertex_count - 1 : vertex_count - 2;
+		if(end < 0 || vertices[0].arc_count == 0)
+			return;
+		
+		// -- Find the segment.
+		
+		float segment_start = 0;
+		
+		if(@length_index != null && length_index.count == end + 1)
+		{
+			segment_index = length_index.find(distance, segment_start);
+		}
+		else
+		{
+			segment_index = 0;
+			while(segment_index < end && segment_start + vertices[segment_index].length <= distance)
+			{
+				segment_start += vertices[segment_index++].length;
+			}
+		}
+		
+		if(@distance_fit != null && distance_fit.eval(segment_index, distance - segment_start, out_t))
+			return;
+		
+		out_t = segment_distance_to_t(arcs, vertices[segment_index], distance - segment_start);
+	}
+	
+	/** Converts a distance relative to the start of a segment to a t value within that segment, using a binary search over its arcs.
+	  * @param v The vertex/segment. Must have valid arcs.
+	  * @param distance The distance from the start of the segment.
+	  * @return The t value within the segment. */
+	float segment_distance_to_t(CurveArcs@ arcs, CurveVertex@ v, const float distance)
+	{
+		const array<float>@ total_length = @arcs.total_length;
+		
+		if(distance <= 0)
+			return 0;
+		if(distance >= total_length[v.arc_from_end()])
+			return 1;
+		
+		int j1 = v.arc_offset + 1;
+		int j2 = v.arc_from_end();
+		while(j1 < j2)
+		{
+			const int mid = (j1 + j2) / 2;
+			if(total_length[mid] < distance)
+			{
+				j1 = mid + 1;
+			}
+			else
+			{
+				j2 = mid;
+			}
+		}
+		
+		return arcs.length[j1] != 0
+			? arcs.t[j1 - 1] + arcs.t_length[j1] * ((distance - total_length[j1 - 1]) / arcs.length[j1])
+			: arcs.t[j1];
+	}
+	
+	/** Converts a segment index and t value to a distance along a curve using the precomputed arcs from `calculate_arc_lengths`.
+	  * The arc containing `t` is found with a binary search and the distance is linearly interpolated within it.
+	  * @param segment_index The index of a segment between 0 and the number of segments.
+	  * @param t The t value within `segment_index`.
+	  * @param length_index If provided is used to find the start of the segment in O(log n), otherwise the lengths of all previous segments are summed.
+	  * @return The distance from the start of the curve. */
+	float t_to_distance(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed, CurveArcs@ arcs,
+		int segment_index, const float t,
+		CurveLengthIndex@ length_index=null)
+	{
+		const int end = closed ? vertex_count - 1 : vertex_count - 2;
+		if(end < 0 || vertices[0].arc_count == 0)
+			return 0;
+		
+		segment_index = segment_index < 0 ? 0 : segment_index > end ? end : segment_index;
+		
+		float segment_start = 0;
+		
+		if(@length_index != null && length_index.count == end + 1)
+		{
+			segment_start = length_index.start_of(segment_index);
+		}
+		else
+		{
+			for(int i = 0; i < segment_index; i++)
+			{
+				segment_start += vertices[i].length;
+			}
+		}
+		
+		return segment_start + segment_t_to_distance(arcs, vertices[segment_index], t);
+	}
+	
+	/** Converts a t value within a segment to a distance relative to the start of that segment, using a binary search over its arcs.
+	  * @param v The vertex/segment. Must have valid arcs.
+	  * @param t The t value within the segment.
+	  * @return The distance from the start of the segment. */
+	float segment_t_to_distance(CurveArcs@ arcs, CurveVertex@ v, const float t)
+	{
+		const array<float>@ arc_t = @arcs.t;
+		
+		if(t <= 0)
+			return 0;
+		if(t >= 1)
+			return arcs.total_length[v.arc_from_end()];
+		
+		int j1 = v.arc_offset + 1;
+		int j2 = v.arc_from_end();
+		while(j1 < j2)
+		{
+			const int mid = (j1 + j2) / 2;
+			if(arc_t[mid] < t)
+			{
+				j1 = mid + 1;
+			}
+			else
+			{
+				j2 = mid;
+			}
+		}
+		
+		return arcs.t_length[j1] != 0
+			? arcs.total_length[j1 - 1] + arcs.length[j1] * ((t - arc_t[j1 - 1]) / arcs.t_length[j1])
+			: arcs.total_length[j1];
+	}
+	
+	/** Places points at regular distances along a curve using the precomputed arcs from `calculate_arc_lengths`.
+	  * The arcs are walked once with a cursor that only moves forward, so the cost is proportional to the number of samples plus the number of arcs.
+	  * @param arcs The arcs calculated by `calculate_arc_lengths`.
+	  * @param eval The curve evaluation function. Only used when `eval_curve` is true.
+	  * @param spacing The distance between each sample. Must be > 0.
+	  * @param offset The distance along the curve of the first sample. Values outside of the range 0..`spacing` will be wrapped.
+	  * @param out_x out_y Receives the position of each sample. Will be resized if required.
+	  * @param out_nx out_ny Receives the normal of each sample. Will be resized if required.
+	  * @param eval_curve If true each sample is evaluated on the curve itself, otherwise the position and normal will be interpolated from the arcs,
+	  *   which is faster but less accurate for low resolution subdivisions.
+	  * @return The number of samples written to the output arrays. */
+	int sample_uniform(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed, CurveArcs@ arcs,
+		EvalFunc@ eval, const float spacing, float offset,
+		array<float>@ out_x, array<float>@ out_y, array<float>@ out_nx, array<float>@ out_ny,
+		const bool eval_curve=true)
+	{
+		const int end = closed ? vertex_count - 1 : vertex_count - 2;
+		if(end < 0 || spacing <= 0 || vertices[0].arc_count == 0)
+			return 0;
+		
+		float total_length = 0;
+		for(int i = 0; i <= end; i++)
+		{
+			total_length += vertices[i].length;
+		}
+		
+		offset = offset % spacing;
+		if(offset < 0)
+		{
+			offset += spacing;
+		}
+		
+		const int count = int((total_length - offset) / spacing) + 1;
+		if(count <= 0)
+			return 0;
+		
+		if(int(out_x.length) < count) out_x.resize(count);
+		if(int(out_y.length) < count) out_y.resize(count);
+		if(int(out_nx.length) < count) out_nx.resize(count);
+		if(int(out_ny.length) < count) out_ny.resize(count);
+		
+		int i = 0;
+		int j = 1;
+		CurveVertex@ v = vertices[0];
+		float segment_start = 0;
+		
+		for(int k = 0; k < count; k++)
+		{
+			const float distance = offset + k * spacing;
+			
+			// Advance to the arc containing the current distance.
+			while(true)
+			{
+				if(j >= v.arc_count)
+				{
+					if(i >= end)
+					{
+						j = v.arc_count - 1;
+						break;
+					}
+					
+					segment_start += v.length;
+					@v = vertices[++i];
+					j = 1;
+					continue;
+				}
+				
+				if(segment_start + arcs.total_length[v.arc_offset + j] >= distance)
+					break;
+				
+				j++;
+			}
+			
+			const int c = v.arc_offset + j;
+			const float f = arcs.length[c] != 0
+				? clamp01((distance - segment_start - arcs.total_length[c - 1]) / arcs.length[c])
+				: 1.0;
+			
+			if(eval_curve)
+			{
+				float x, y, nx, ny;
+				eval(i, arcs.t[c - 1] + arcs.t_length[c] * f, x, y, nx, ny);
+				out_x[k] = x;
+				out_y[k] = y;
+				out_nx[k] = nx;
+				out_ny[k] = ny;
+			}
+			else
+			{
+				out_x[k] = arcs.x[c - 1] + arcs.dx[c] * f;
+				out_y[k] = arcs.y[c - 1] + arcs.dy[c] * f;
+				out_nx[k] = arcs.nx[c];
+				out_ny[k] = arcs.ny[c];
+			}
+		}
+		
+		return count;
+	}
+	
+}
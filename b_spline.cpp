@@ -6,6 +6,12 @@ class BSpline
 	/** The ratio/weight calculated during the last call to `eval_**`. */
 	float last_w;
 	
+	/** True if `generate_bezier` has been called since the vertices or knots last changed. */
+	bool has_bezier
+	{
+		get const { return bezier_span_count > 0; }
+	}
+	
 	private array<float> knots(32);
 	private int knots_length;
 	
@@ -18,11 +24,34 @@ class BSpline
 	private array<array<float>> ders;
 	private array<array<float>> b_a;
 	private array<float> basis_list(32);
+	private array<float> basis_der_list(32);
+	/** Pascal's triangle, stored row by row. See `get_binomial`. */
+	private array<int> binomials;
+	private int binomials_n = -1;
 	private array<CurvePoint> v_ders(32);
 	private array<float> w_ders(32);
 	private array<float> left(32);
 	private array<float> right(32);
 	
+	/** The rational bezier control points of each knot span, generated by `generate_bezier`. Each point's `w` is its weight. */
+	private array<CurvePointW> bezier_points;
+	private array<bool> bezier_rational;
+	private int bezier_span_count;
+	private int bezier_degree;
+	private bool bezier_clamped;
+	private bool bezier_closed;
+	private array<CurvePointW> blossom_points(8);
+	private array<CurvePointW> bezier_scratch(8);
+	
+	/** The range of spans whose surrounding knots are all uniformly spaced, and can use the precomputed `uniform_matrices`. */
+	private int uniform_span_min;
+	private int uniform_span_max = -1;
+	private int uniform_degree;
+	/** The power basis coefficients of the uniform basis functions for each degree up to `uniform_max_degree`, stored row by row.
+	  * The matrix for degree `d` starts at `d * (d + 1) * (2 * d + 1) / 6`. */
+	private array<float> uniform_matrices;
+	private int uniform_max_degree = 7;
+	
 	/** Sets the vertices for this spline.
 	  * Only needs to be called initially or once after the number of, position, or weight of any vertices change. */
 	void set_vertices(
@@ -31,6 +60,7 @@ class BSpline
 	{
 		this.vertex_count = vertex_count;
 		@this.vertices = vertices;
+		bezier_span_count = 0;
 		
 		int v_count, degree_c;
 		init_params(vertex_count, degree, clamped, closed, v_count, degree_c);
@@ -63,6 +93,7 @@ class BSpline
 		init_params(vertex_count, degree, clamped, closed, v_count, degree_c);
 		
 		knots_length = v_count + degree_c + 1;
+		bezier_span_count = 0;
 		while(int(knots.length) < knots_length)
 		{
 			knots.resize(knots.length * 2);
@@ -74,6 +105,39 @@ class BSpline
 				? min(max(i - degree_c, 0), knots_length - degree_c * 2 - 1)
 				: i - degree_c;
 		}
+		
+		// Find the spans where every knot used by the basis functions is exactly one apart.
+		// For unclamped curves this is all of them, and for clamped curves all but the spans near each end.
+		uniform_degree = degree_c;
+		uniform_span_min = v_count;
+		uniform_span_max = -1;
+		
+		if(degree_c > uniform_max_degree)
+			return;
+		
+		for(int span = degree_c; span < v_count; span++)
+		{
+			bool uniform = true;
+			for(int i = span + 1 - degree_c; i < span + degree_c; i++)
+			{
+				if(knots[i + 1] - knots[i] != 1)
+				{
+					uniform = false;
+					break;
+				}
+			}
+			
+			if(!uniform)
+				continue;
+			
+			if(span < uniform_span_min) uniform_span_min = span;
+			if(span > uniform_span_max) uniform_span_max = span;
+		}
+		
+		if(uniform_matrices.length == 0)
+		{
+			init_uniform_matrices();
+		}
 	}
 	
 	// -- Eval --
@@ -121,48 +185,31 @@ class BSpline
 			}
 		}
 		
-		// Initialize result to 0s.
-		x = 0;
-		y = 0;
-		float w = 0;
-		
 		if(v_count <= degree_c)
+		{
+			x = 0;
+			y = 0;
+			normal_x = 1;
+			normal_y = 0;
 			return;
+		}
 		
 		const float u = init_t(v_count, degree_c, closed, t);
 		
-		// Find span and corresponding non-zero basis functions.
-		const int span = find_span(degree_c, u);
-		calc_basis(degree_c, span, u);
-		
-		for(int i = 0; i <= degree_c; i++)
+		float dx, dy;
+		if(uses_bezier(degree_c, clamped, closed))
 		{
-			const int j = span - degree_c + i;
-			if(j < 0 || j >= v_count)
-				continue;
-			
-			CurvePointW@ p = vertices_weighted[j];
-			const float ni = basis_list[i];
-			x += p.x * ni;
-			y += p.y * ni;
-			w += p.w * ni;
+			eval_bezier_point(u, x, y);
+			eval_bezier_derivative(u, dx, dy);
 		}
-		
-		// Convert back to cartesian coordinates.
-		if(w != 0)
+		else
 		{
-			x /= w;
-			y /= w;
+			eval_point_derivative(degree_c, v_count, find_span(degree_c, u), u, x, y, dx, dy);
 		}
 		
-		last_w = w;
-		
 		// Calculate the normal vector.
-		curve_derivatives_rational(degree_c, closed, u, 1, span);
-
-		CurvePointW@ du = @curve_ders[1];
-		normal_x = du.y;
-		normal_y = -du.x;
+		normal_x = dy;
+		normal_y = -dx;
 		
 		const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
 		if(length != 0)
@@ -217,6 +264,12 @@ class BSpline
 		
 		const float u = init_t(v_count, degree_c, closed, t);
 		
+		if(uses_bezier(degree_c, clamped, closed))
+		{
+			eval_bezier_point(u, x, y);
+			return;
+		}
+		
 		// Find span and corresponding non-zero basis functions
 		const int span = find_span(degree_c, u);
 		calc_basis(degree_c, span, u);
@@ -277,12 +330,17 @@ class BSpline
 		const float u = init_t(v_count, degree_c, closed, t);
 		
 		// Calculate the normal vector.
-		curve_derivatives_rational(degree_c, closed, u, 1);
-
-		CurvePointW@ du = @curve_ders[1];
-		normal_x = du.y;
-		normal_y = -du.x;
-		last_w = du.w;
+		float x, y, dx, dy;
+		if(uses_bezier(degree_c, clamped, closed))
+		{
+			eval_bezier_derivative(u, dx, dy);
+		}
+		else
+		{
+			eval_point_derivative(degree_c, v_count, find_span(degree_c, u), u, x, y, dx, dy);
+		}
+		normal_x = dy;
+		normal_y = -dx;
 		
 		const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
 		if(length != 0)
@@ -292,6 +350,56 @@ class BSpline
 		}
 	}
 	
+	/** Returns the first derivative with respect to `t` at the given `t` value. */
+	void eval_derivative(
+		const int degree, const bool clamped, const bool closed,
+		const float t, float &out dx, float &out dy)
+	{
+		int v_count, degree_c;
+		init_params(vertex_count, degree, clamped, closed, v_count, degree_c);
+		
+		switch(v_count)
+		{
+			case 2:
+			{
+				dx = vertices[1].x - vertices[0].x;
+				dy = vertices[1].y - vertices[0].y;
+				return;
+			}
+			case 1:
+			case 0:
+			{
+				dx = 0;
+				dy = 0;
+				return;
+			}
+		}
+		
+		if(v_count <= degree_c)
+		{
+			dx = 0;
+			dy = 0;
+			return;
+		}
+		
+		const float u = init_t(v_count, degree_c, closed, t);
+		
+		if(uses_bezier(degree_c, clamped, closed))
+		{
+			eval_bezier_derivative(u, dx, dy);
+		}
+		else
+		{
+			float x, y;
+			eval_point_derivative(degree_c, v_count, find_span(degree_c, u), u, x, y, dx, dy);
+		}
+		
+		// Scale from knot space back to t.
+		const float du = (closed ? 1 - 1.0 / (vertex_count + 1) : 1.0) * (v_count - degree_c);
+		dx *= du;
+		dy *= du;
+	}
+	
 	/** Returns the ratio/weight at the given t value. */
 	float eval_ratio(
 		const int degree, const bool clamped, const bool closed,
@@ -325,6 +433,13 @@ class BSpline
 		
 		const float u = init_t(v_count, degree_c, closed, t);
 		
+		if(uses_bezier(degree_c, clamped, closed))
+		{
+			float x, y;
+			eval_bezier_point(u, x, y);
+			return last_w;
+		}
+		
 		// Find span and corresponding non-zero basis functions
 		const int span = find_span(degree_c, u);
 		calc_basis(degree_c, span, u);
@@ -341,6 +456,314 @@ class BSpline
 		return w;
 	}
 	
+	/** Calculates the point and normal at each t value in `ts` between `start` and `end` (exclusive).
+	  * The parameters are only initialised once, and the span search is skipped while consecutive t values stay within the same span.
+	  * The results for `ts[i]` are written to `out_xy[i * 2]`/`out_xy[i * 2 + 1]` and `out_normals[i * 2]`/`out_normals[i * 2 + 1]`.
+	  * If `out_normals` is null only the points are calculated. */
+	void eval_many(
+		const int degree, const bool clamped, const bool closed,
+		array<float>@ ts, const int start, const int end, array<float>@ out_xy, array<float>@ out_normals)
+	{
+		int v_count, degree_c;
+		init_params(vertex_count, degree, clamped, closed, v_count, degree_c);
+		
+		// Degenerate curves are rare enough to not be worth specialising.
+		if(v_count <= 2 || v_count <= degree_c)
+		{
+			for(int i = start; i < end; i++)
+			{
+				float x, y, normal_x, normal_y;
+				eval(degree, clamped, closed, ts[i], x, y, normal_x, normal_y);
+				out_xy[i * 2] = x;
+				out_xy[i * 2 + 1] = y;
+				
+				if(out_normals !is null)
+				{
+					out_normals[i * 2] = normal_x;
+					out_normals[i * 2 + 1] = normal_y;
+				}
+			}
+			return;
+		}
+		
+		const float u_scale = (closed ? 1 - 1.0 / (vertex_count + 1) : 1.0) * (v_count - degree_c);
+		const float u_min = knots[degree_c];
+		const float u_max = knots[knots_length - degree_c - 1];
+		
+		if(uses_bezier(degree_c, clamped, closed))
+		{
+			for(int i = start; i < end; i++)
+			{
+				const float u = ts[i] * u_scale;
+				
+				float x, y;
+				eval_bezier_point(u, x, y);
+				out_xy[i * 2] = x;
+				out_xy[i * 2 + 1] = y;
+				
+				if(out_normals is null)
+					continue;
+				
+				float dx, dy;
+				eval_bezier_derivative(u, dx, dy);
+				float normal_x = dy;
+				float normal_y = -dx;
+				
+				const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+				if(length != 0)
+				{
+					normal_x /= length;
+					normal_y /= length;
+				}
+				
+				out_normals[i * 2] = normal_x;
+				out_normals[i * 2 + 1] = normal_y;
+			}
+			return;
+		}
+		
+		int span = -1;
+		
+		for(int i = start; i < end; i++)
+		{
+			const float u = ts[i] * u_scale;
+			
+			if(span == -1 || u < knots[span] || u >= knots[span + 1] || u <= u_min || u >= u_max)
+			{
+				span = find_span(degree_c, u);
+			}
+			
+			if(out_normals is null)
+			{
+				calc_basis(degree_c, span, u);
+				
+				float x = 0;
+				float y = 0;
+				float w = 0;
+				for(int j = 0; j <= degree_c; j++)
+				{
+					const int k = span - degree_c + j;
+					if(k < 0 || k >= v_count)
+						continue;
+					
+					CurvePointW@ p = vertices_weighted[k];
+					const float ni = basis_list[j];
+					x += p.x * ni;
+					y += p.y * ni;
+					w += p.w * ni;
+				}
+				
+				if(w != 0)
+				{
+					x /= w;
+					y /= w;
+				}
+				
+				out_xy[i * 2] = x;
+				out_xy[i * 2 + 1] = y;
+				last_w = w;
+				continue;
+			}
+			
+			float x, y, dx, dy;
+			eval_point_derivative(degree_c, v_count, span, u, x, y, dx, dy);
+			out_xy[i * 2] = x;
+			out_xy[i * 2 + 1] = y;
+			
+			float normal_x = dy;
+			float normal_y = -dx;
+			
+			const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+			if(length != 0)
+			{
+				normal_x /= length;
+				normal_y /= length;
+			}
+			
+			out_normals[i * 2] = normal_x;
+			out_normals[i * 2 + 1] = normal_y;
+		}
+	}
+	
+	// -- Spans --
+	
+	/** Calculates the parameters used by the `*_span` methods. These only change when the vertex count, degree, clamped, or closed
+	  * properties do, so can be calculated once and reused for many evaluations, e.g. by a `BSplineCursor`.
+	  * @param u_scale Converts a `t` value for the whole curve into a knot value, `u = t * u_scale`.
+	  * @return False if the curve is degenerate and can't be evaluated by span, in which case the regular `eval` methods must be used. */
+	bool init_span_params(
+		const int degree, const bool clamped, const bool closed,
+		int &out v_count, int &out degree_c, float &out u_scale)
+	{
+		init_params(vertex_count, degree, clamped, closed, v_count, degree_c);
+		u_scale = init_t(v_count, degree_c, closed, 1);
+		
+		return v_count > 2 && v_count > degree_c;
+	}
+	
+	/** Returns the knot span containing `u`. If `u` is still within `span` or the one after it, as is the case when stepping along
+	  * the curve, no other knots are checked. Otherwise the span is calculated directly since the knots within the domain are always
+	  * uniform integers, so no search is ever needed.
+	  * @param span The last span returned, or -1. */
+	int find_span_from(const int degree_c, const float u, const int span)
+	{
+		const int n = knots_length - degree_c - 2;
+		
+		if(span >= degree_c && span <= n)
+		{
+			if(u >= knots[span] && u < knots[span + 1])
+				return span;
+			if(span < n && u >= knots[span + 1] && u < knots[span + 2])
+				return span + 1;
+		}
+		
+		if(u >= knots[n + 1])
+			return n;
+		if(u <= knots[degree_c])
+			return degree_c;
+		
+		const int direct = degree_c + int(floor(u - knots[degree_c]));
+		return direct < degree_c ? degree_c : direct > n ? n : direct;
+	}
+	
+	/** Returns the point and normal at the knot value `u`, which must lie within the given knot span.
+	  * `degree_c` and `v_count` must come from `init_span_params` with the same degree, clamped, and closed properties. */
+	void eval_span(
+		const int degree_c, const int v_count, const bool clamped, const bool closed,
+		const int span, const float u, float &out x, float &out y, float &out normal_x, float &out normal_y)
+	{
+		float dx, dy;
+		if(uses_bezier(degree_c, clamped, closed))
+		{
+			const int k = span - degree_c;
+			const float t = u - knots[span];
+			eval_bezier_span_point(k, t, x, y);
+			eval_bezier_span_derivative(k, t, dx, dy);
+		}
+		else
+		{
+			eval_point_derivative(degree_c, v_count, span, u, x, y, dx, dy);
+		}
+		
+		normal_x = dy;
+		normal_y = -dx;
+		
+		const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+		if(length != 0)
+		{
+			normal_x /= length;
+			normal_y /= length;
+		}
+	}
+	
+	/** Returns the point at the knot value `u`. See `eval_span`. */
+	void eval_span_point(
+		const int degree_c, const int v_count, const bool clamped, const bool closed,
+		const int span, const float u, float &out x, float &out y)
+	{
+		if(uses_bezier(degree_c, clamped, closed))
+		{
+			eval_bezier_span_point(span - degree_c, u - knots[span], x, y);
+			return;
+		}
+		
+		calc_basis(degree_c, span, u);
+		
+		x = 0;
+		y = 0;
+		float w = 0;
+		for(int i = 0; i <= degree_c; i++)
+		{
+			CurvePointW@ p = vertices_weighted[span - degree_c + i];
+			const float ni = basis_list[i];
+			x += p.x * ni;
+			y += p.y * ni;
+			w += p.w * ni;
+		}
+		
+		if(w != 0)
+		{
+			x /= w;
+			y /= w;
+		}
+		
+		last_w = w;
+	}
+	
+	/** Returns the first derivative with respect to `u` at the knot value `u`. See `eval_span`. */
+	void eval_span_derivative(
+		const int degree_c, const int v_count, const bool clamped, const bool closed,
+		const int span, const float u, float &out dx, float &out dy)
+	{
+		if(uses_bezier(degree_c, clamped, closed))
+		{
+			eval_bezier_span_derivative(span - degree_c, u - knots[span], dx, dy);
+			return;
+		}
+		
+		float x, y;
+		eval_point_derivative(degree_c, v_count, span, u, x, y, dx, dy);
+	}
+	
+	// -- Bezier --
+	
+	/** Converts each knot span into a rational bezier curve by knot insertion (blossoming), so that evaluation no longer needs to search
+	  * for the span or calculate the basis functions.
+	  * Once generated, all `eval_**` methods called with the same degree, clamped, and closed values will use the bezier form.
+	  * Must be called again after `set_vertices` or `generate_knots`, which discard the bezier form. */
+	void generate_bezier(const int degree, const bool clamped, const bool closed)
+	{
+		int v_count, degree_c;
+		init_params(vertex_count, degree, clamped, closed, v_count, degree_c);
+		
+		bezier_span_count = 0;
+		
+		if(v_count <= 2 || v_count <= degree_c)
+			return;
+		
+		const int span_count = v_count - degree_c;
+		const int size = span_count * (degree_c + 1);
+		
+		if(int(bezier_points.length) < size)
+		{
+			bezier_points.resize(size);
+		}
+		if(int(bezier_rational.length) < span_count)
+		{
+			bezier_rational.resize(span_count);
+		}
+		
+		for(int k = 0; k < span_count; k++)
+		{
+			const int span = k + degree_c;
+			const int offset = k * (degree_c + 1);
+			blossom_span(degree_c, span, knots[span], knots[span + 1], bezier_points, offset);
+			
+			bool rational = false;
+			for(int j = 1; j <= degree_c; j++)
+			{
+				if(bezier_points[offset + j].w != bezier_points[offset].w)
+				{
+					rational = true;
+					break;
+				}
+			}
+			
+			bezier_rational[k] = rational;
+		}
+		
+		bezier_span_count = span_count;
+		bezier_degree = degree_c;
+		bezier_clamped = clamped;
+		bezier_closed = closed;
+	}
+	
+	/** Discards the bezier form generated by `generate_bezier`. */
+	void clear_bezier()
+	{
+		bezier_span_count = 0;
+	}
+	
 	// -- Bounding boxes --
 	
 	/** Calculates an approximate bounding box by simply finding the min and max of all vertices. */
@@ -385,10 +808,10 @@ class BSpline
 		}
 	}
 	
-	/** Calculates an approximate bounding box by taking the min/max of the vertices and first and last arc segment position.
-	  * Gives a tighter bounding box than `bounding_box_simple`, but requires arc lengths to have been updated. */
+	/** Calculates an approximate bounding box by taking the min/max of the vertices and the start and end position of each segment.
+	  * Gives a tighter bounding box than `bounding_box_simple`. */
 	void bounding_box_basic(
-		const int vertex_count, const int degree, const bool closed,
+		const int vertex_count, const int degree, const bool clamped, const bool closed,
 		float &out x1, float &out y1, float &out x2, float &out y2)
 	{
 		if(vertex_count == 0)
@@ -402,6 +825,10 @@ class BSpline
 		x2 = y2 = -INFINITY;
 		
 		const int end = closed ? vertex_count : vertex_count - 1;
+		
+		float sx, sy;
+		eval_point(degree, clamped, closed, 0, sx, sy);
+		
 		for(int i = 0; i < end; i++)
 		{
 			CurveVertex@ v = vertices[i];
@@ -409,14 +836,21 @@ class BSpline
 			v.x1 = v.x2 = v.x;
 			v.y1 = v.y2 = v.y;
 			
-			for(int j = 0; j < 2; j++)
-			{
-				CurveArc@ arc = j == 0 ? v.arcs[0] : v.arcs[v.arc_count - 1];
-				if(arc.x < v.x1) v.x1 = arc.x;
-				if(arc.y < v.y1) v.y1 = arc.y;
-				if(arc.x > v.x2) v.x2 = arc.x;
-				if(arc.y > v.y2) v.y2 = arc.y;
-			}
+			// The end of each segment is the start of the next.
+			float ex, ey;
+			eval_point(degree, clamped, closed, float(i + 1) / end, ex, ey);
+			
+			if(sx < v.x1) v.x1 = sx;
+			if(sy < v.y1) v.y1 = sy;
+			if(sx > v.x2) v.x2 = sx;
+			if(sy > v.y2) v.y2 = sy;
+			if(ex < v.x1) v.x1 = ex;
+			if(ey < v.y1) v.y1 = ey;
+			if(ex > v.x2) v.x2 = ex;
+			if(ey > v.y2) v.y2 = ey;
+			
+			sx = ex;
+			sy = ey;
 			
 			for(int j = i + o1; j <= i + o2; j++)
 			{
@@ -439,6 +873,65 @@ class BSpline
 		}
 	}
 	
+	/** Calculates the bounding box of each segment from the bezier form of the knot spans it covers.
+	  * Exact for degree 2 and 3 curves, otherwise the bounding box of the bezier control points, which is still much tighter than
+	  * `bounding_box_basic`. Falls back to `bounding_box_basic` for curves with too few vertices. */
+	void bounding_box_bezier(
+		const int vertex_count, const int degree, const bool clamped, const bool closed,
+		float &out x1, float &out y1, float &out x2, float &out y2)
+	{
+		int v_count, degree_c;
+		init_params(vertex_count, degree, clamped, closed, v_count, degree_c);
+		
+		if(v_count <= 2 || v_count <= degree_c)
+		{
+			bounding_box_basic(vertex_count, degree, clamped, closed, x1, y1, x2, y2);
+			return;
+		}
+		
+		x1 = y1 = INFINITY;
+		x2 = y2 = -INFINITY;
+		
+		const int end = closed ? vertex_count : vertex_count - 1;
+		const int span_count = v_count - degree_c;
+		
+		for(int i = 0; i < end; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			v.x1 = v.y1 = INFINITY;
+			v.x2 = v.y2 = -INFINITY;
+			
+			const float u1 = init_t(v_count, degree_c, closed, float(i) / end);
+			const float u2 = init_t(v_count, degree_c, closed, float(i + 1) / end);
+			
+			for(int span = find_span(degree_c, u1); span < degree_c + span_count; span++)
+			{
+				const float a = max(u1, knots[span]);
+				const float b = min(u2, knots[span + 1]);
+				if(b < a)
+					break;
+				
+				blossom_span(degree_c, span, a, b, bezier_scratch, 0);
+				
+				float bx1, by1, bx2, by2;
+				bounding_box_bezier_points(degree_c, bx1, by1, bx2, by2);
+				
+				if(bx1 < v.x1) v.x1 = bx1;
+				if(by1 < v.y1) v.y1 = by1;
+				if(bx2 > v.x2) v.x2 = bx2;
+				if(by2 > v.y2) v.y2 = by2;
+				
+				if(b >= u2)
+					break;
+			}
+			
+			if(v.x1 < x1) x1 = v.x1;
+			if(v.y1 < y1) y1 = v.y1;
+			if(v.x2 > x2) x2 = v.x2;
+			if(v.y2 > y2) y2 = v.y2;
+		}
+	}
+	
 	/** Returns the range indicating how many vertices on each side of any given vertex will affect that vertex. */
 	void get_affected_vertex_offsets(const int vertex_count, const int degree, const bool closed, int &out o1, int &out o2)
 	{
@@ -650,6 +1143,270 @@ class BSpline
 		return t * (closed ? 1 - 1.0 / (vertex_count + 1) : 1.0) * (v_count - degree);
 	}
 	
+	private bool uses_bezier(const int degree, const bool clamped, const bool closed)
+	{
+		return bezier_span_count > 0 && bezier_degree == degree && bezier_clamped == clamped && bezier_closed == closed;
+	}
+	
+	/** Returns the index of the bezier span containing `u`, and the t value within it.
+	  * The knots within the domain are always uniform integers, so no search is needed. */
+	private int get_bezier_span(const float u, float &out t)
+	{
+		int k = int(floor(u - knots[bezier_degree]));
+		k = k < 0 ? 0 : k >= bezier_span_count ? bezier_span_count - 1 : k;
+		
+		const float k1 = knots[k + bezier_degree];
+		const float k2 = knots[k + bezier_degree + 1];
+		t = k2 != k1 ? (u - k1) / (k2 - k1) : 0.0;
+		
+		return k;
+	}
+	
+	private void eval_bezier_point(const float u, float &out x, float &out y)
+	{
+		float t;
+		const int k = get_bezier_span(u, t);
+		eval_bezier_span_point(k, t, x, y);
+	}
+	
+	/** Calculates the point at `t` within the bezier span `k`. */
+	private void eval_bezier_span_point(const int k, const float t, float &out x, float &out y)
+	{
+		const int o = k * (bezier_degree + 1);
+		
+		switch(bezier_degree)
+		{
+			case 2:
+			{
+				CurvePointW@ p1 = @bezier_points[o];
+				CurvePointW@ p2 = @bezier_points[o + 1];
+				CurvePointW@ p3 = @bezier_points[o + 2];
+				
+				if(!bezier_rational[k])
+				{
+					QuadraticBezier::eval_point(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, t, x, y);
+					last_w = p1.w;
+				}
+				else
+				{
+					QuadraticBezier::eval_point(
+						p1.x, p1.y, p2.x, p2.y, p3.x, p3.y,
+						p1.w, p2.w, p3.w,
+						t, x, y);
+					const float s = 1 - t;
+					last_w = s * s * p1.w + 2 * s * t * p2.w + t * t * p3.w;
+				}
+				return;
+			}
+			case 3:
+			{
+				CurvePointW@ p1 = @bezier_points[o];
+				CurvePointW@ p2 = @bezier_points[o + 1];
+				CurvePointW@ p3 = @bezier_points[o + 2];
+				CurvePointW@ p4 = @bezier_points[o + 3];
+				
+				if(!bezier_rational[k])
+				{
+					CubicBezier::eval_point(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y, t, x, y);
+					last_w = p1.w;
+				}
+				else
+				{
+					CubicBezier::eval_point(
+						p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y,
+						p1.w, p2.w, p3.w, p4.w,
+						t, x, y);
+					const float s = 1 - t;
+					last_w = s * s * s * p1.w + 3 * s * s * t * p2.w + 3 * s * t * t * p3.w + t * t * t * p4.w;
+				}
+				return;
+			}
+		}
+		
+		Bezier::eval_point(bezier_points, o, bezier_degree, t, x, y, last_w);
+	}
+	
+	/** Calculates the derivative with respect to `u`. */
+	private void eval_bezier_derivative(const float u, float &out dx, float &out dy)
+	{
+		float t;
+		const int k = get_bezier_span(u, t);
+		eval_bezier_span_derivative(k, t, dx, dy);
+	}
+	
+	/** Calculates the derivative with respect to `u` at `t` within the bezier span `k`. */
+	private void eval_bezier_span_derivative(const int k, const float t, float &out dx, float &out dy)
+	{
+		const int o = k * (bezier_degree + 1);
+		
+		switch(bezier_degree)
+		{
+			case 2:
+			{
+				CurvePointW@ p1 = @bezier_points[o];
+				CurvePointW@ p2 = @bezier_points[o + 1];
+				CurvePointW@ p3 = @bezier_points[o + 2];
+				
+				if(!bezier_rational[k])
+				{
+					QuadraticBezier::eval_derivative(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, t, dx, dy);
+				}
+				else
+				{
+					QuadraticBezier::eval_derivative(
+						p1.x, p1.y, p2.x, p2.y, p3.x, p3.y,
+						p1.w, p2.w, p3.w,
+						t, dx, dy);
+				}
+				break;
+			}
+			case 3:
+			{
+				CurvePointW@ p1 = @bezier_points[o];
+				CurvePointW@ p2 = @bezier_points[o + 1];
+				CurvePointW@ p3 = @bezier_points[o + 2];
+				CurvePointW@ p4 = @bezier_points[o + 3];
+				
+				if(!bezier_rational[k])
+				{
+					CubicBezier::eval_derivative(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y, t, dx, dy);
+				}
+				else
+				{
+					CubicBezier::eval_derivative(
+						p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y,
+						p1.w, p2.w, p3.w, p4.w,
+						t, dx, dy);
+				}
+				break;
+			}
+			default:
+			{
+				float x, y, w;
+				Bezier::eval(bezier_points, o, bezier_degree, t, x, y, dx, dy, w);
+				break;
+			}
+		}
+		
+		// Scale from the span's t back to u.
+		const float width = knots[k + bezier_degree + 1] - knots[k + bezier_degree];
+		if(width != 0)
+		{
+			dx /= width;
+			dy /= width;
+		}
+	}
+	
+	/** Calculates the bezier control points of the curve between `a` and `b`, which must lie within the given knot span, and writes them
+	  * to `out_points` starting at `offset`. Each control point is the blossom of the span's vertices with `a` repeated `degree - j` times
+	  * and `b` repeated `j` times, which is equivalent to inserting `a` and `b` until they each have full multiplicity. */
+	private void blossom_span(
+		const int degree, const int span, const float a, const float b,
+		array<CurvePointW>@ out_points, const int offset)
+	{
+		if(int(blossom_points.length) < degree + 1)
+		{
+			blossom_points.resize(degree + 1);
+		}
+		if(int(out_points.length) < offset + degree + 1)
+		{
+			out_points.resize(offset + degree + 1);
+		}
+		
+		for(int j = 0; j <= degree; j++)
+		{
+			for(int i = 0; i <= degree; i++)
+			{
+				CurvePointW@ src = @vertices_weighted[span - degree + i];
+				CurvePointW@ dst = @blossom_points[i];
+				dst.x = src.x;
+				dst.y = src.y;
+				dst.w = src.w;
+			}
+			
+			// de Boor's algorithm with a different argument at each level.
+			for(int r = 1; r <= degree; r++)
+			{
+				const float arg = r <= degree - j ? a : b;
+				
+				for(int i = degree; i >= r; i--)
+				{
+					const int ki = span - degree + i;
+					const float k1 = knots[ki];
+					const float k2 = knots[ki + degree + 1 - r];
+					const float alpha = k2 != k1 ? (arg - k1) / (k2 - k1) : 0.0;
+					
+					CurvePointW@ p0 = @blossom_points[i - 1];
+					CurvePointW@ p1 = @blossom_points[i];
+					p1.x = (1 - alpha) * p0.x + alpha * p1.x;
+					p1.y = (1 - alpha) * p0.y + alpha * p1.y;
+					p1.w = (1 - alpha) * p0.w + alpha * p1.w;
+				}
+			}
+			
+			// Convert back to cartesian coordinates.
+			CurvePointW@ result = @blossom_points[degree];
+			CurvePointW@ p = @out_points[offset + j];
+			p.w = result.w;
+			p.x = result.w != 0 ? result.x / result.w : result.x;
+			p.y = result.w != 0 ? result.y / result.w : result.y;
+		}
+	}
+	
+	/** Calculates the bounding box of the bezier control points in `bezier_scratch`. */
+	private void bounding_box_bezier_points(const int degree, float &out x1, float &out y1, float &out x2, float &out y2)
+	{
+		CurvePointW@ p1 = @bezier_scratch[0];
+		CurvePointW@ p2 = @bezier_scratch[1];
+		CurvePointW@ p3 = @bezier_scratch[2];
+		
+		if(degree == 2)
+		{
+			if(p1.w == p2.w && p2.w == p3.w)
+			{
+				QuadraticBezier::bounding_box(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, x1, y1, x2, y2);
+			}
+			else
+			{
+				QuadraticBezier::bounding_box(
+					p1.x, p1.y, p2.x, p2.y, p3.x, p3.y,
+					p1.w, p2.w, p3.w,
+					x1, y1, x2, y2);
+			}
+			return;
+		}
+		
+		if(degree == 3)
+		{
+			CurvePointW@ p4 = @bezier_scratch[3];
+			
+			if(p1.w == p2.w && p2.w == p3.w && p3.w == p4.w)
+			{
+				CubicBezier::bounding_box(p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y, x1, y1, x2, y2);
+			}
+			else
+			{
+				CubicBezier::bounding_box(
+					p1.x, p1.y, p2.x, p2.y, p3.x, p3.y, p4.x, p4.y,
+					p1.w, p2.w, p3.w, p4.w,
+					x1, y1, x2, y2);
+			}
+			return;
+		}
+		
+		// A rational bezier with positive weights always lies within the convex hull of its control points.
+		x1 = y1 = INFINITY;
+		x2 = y2 = -INFINITY;
+		for(int i = 0; i <= degree; i++)
+		{
+			CurvePointW@ p = @bezier_scratch[i];
+			if(p.x < x1) x1 = p.x;
+			if(p.y < y1) y1 = p.y;
+			if(p.x > x2) x2 = p.x;
+			if(p.y > y2) y2 = p.y;
+		}
+	}
+	
 	private void curve_derivatives_rational(
 		const int degree, const bool closed,
 		const float u, const int num_ders, const int span=-1)
@@ -688,7 +1445,7 @@ class BSpline
 			{
 				CurvePointW@ cd = @curve_ders[i - j];
 				const float w = w_ders[j];
-				const float binomial = calc_binomial(i, j) * w;
+				const float binomial = get_binomial(i, j) * w;
 				v.x -= binomial * cd.x;
 				v.y -= binomial * cd.y;
 			}
@@ -747,6 +1504,12 @@ class BSpline
 	
 	private void calc_basis(const int degree, const int span, const float u)
 	{
+		if(degree == uniform_degree && span >= uniform_span_min && span <= uniform_span_max)
+		{
+			calc_basis_uniform(degree, span, u, false);
+			return;
+		}
+		
 		const uint size = degree + 1;
 		
 		while(left.length < size)
@@ -788,6 +1551,193 @@ class BSpline
 		}
 	}
 	
+	/** Calculates the non-zero basis functions and their first derivatives in a single triangular sweep.
+	  * The derivatives only depend on the basis functions of one degree lower, which are the intermediate values of the last iteration,
+	  * so unlike `calc_der_basis` this doesn't need to store the full triangle. */
+	private void calc_basis_der(const int degree, const int span, const float u)
+	{
+		if(degree == uniform_degree && span >= uniform_span_min && span <= uniform_span_max)
+		{
+			calc_basis_uniform(degree, span, u, true);
+			return;
+		}
+		
+		const uint size = degree + 1;
+		
+		while(left.length < size)
+		{
+			left.resize(left.length * 2);
+			right.resize(right.length * 2);
+		}
+		
+		while(basis_list.length < size)
+		{
+			basis_list.resize(basis_list.length * 2);
+		}
+		while(basis_der_list.length < size)
+		{
+			basis_der_list.resize(basis_der_list.length * 2);
+		}
+		
+		basis_list[0] = 1.0;
+		
+		for(int j = 1; j <= degree; j++)
+		{
+			left[j] = u - knots[span + 1 - j];
+			right[j] = knots[span + j] - u;
+			float saved = 0.0;
+			float prev_temp = 0.0;
+			
+			for(int r = 0; r < j; r++)
+			{
+				const float den = right[r + 1] + left[j - r];
+				const float temp = den != 0 ? basis_list[r] / den : 0;
+				basis_list[r] = saved + right[r + 1] * temp;
+				saved = left[j - r] * temp;
+				
+				if(j == degree)
+				{
+					basis_der_list[r] = degree * (prev_temp - temp);
+					prev_temp = temp;
+				}
+			}
+			
+			basis_list[j] = saved;
+			
+			if(j == degree)
+			{
+				basis_der_list[j] = degree * prev_temp;
+			}
+		}
+	}
+	
+	/** Calculates the basis functions, and optionally their first derivatives, for a span surrounded by uniform knots.
+	  * Each basis function is a polynomial in the local u value with precomputed coefficients, so this is a small matrix-vector product. */
+	private void calc_basis_uniform(const int degree, const int span, const float u, const bool derivatives)
+	{
+		const uint size = degree + 1;
+		
+		while(basis_list.length < size)
+		{
+			basis_list.resize(basis_list.length * 2);
+		}
+		while(basis_der_list.length < size)
+		{
+			basis_der_list.resize(basis_der_list.length * 2);
+		}
+		
+		const float s = u - knots[span];
+		const int offset = degree * (degree + 1) * (2 * degree + 1) / 6;
+		
+		for(int i = 0; i <= degree; i++)
+		{
+			const int row = offset + i * (degree + 1);
+			
+			float n = uniform_matrices[row + degree];
+			for(int k = degree - 1; k >= 0; k--)
+			{
+				n = n * s + uniform_matrices[row + k];
+			}
+			basis_list[i] = n;
+			
+			if(!derivatives)
+				continue;
+			
+			float dn = degree * uniform_matrices[row + degree];
+			for(int k = degree - 1; k >= 1; k--)
+			{
+				dn = dn * s + k * uniform_matrices[row + k];
+			}
+			basis_der_list[i] = dn;
+		}
+	}
+	
+	/** Calculates the uniform basis matrices for all degrees up to `uniform_max_degree`, where
+	  * `M[i][k] = C(p, k) / p! * sum(j = i..p, (-1)^(j - i) * C(p + 1, j - i) * (p - j)^(p - k))`. */
+	private void init_uniform_matrices()
+	{
+		const int max_degree = uniform_max_degree;
+		uniform_matrices.resize((max_degree + 1) * (max_degree + 2) * (2 * max_degree + 3) / 6);
+		
+		for(int p = 0; p <= max_degree; p++)
+		{
+			const int offset = p * (p + 1) * (2 * p + 1) / 6;
+			
+			float factorial = 1;
+			for(int i = 2; i <= p; i++)
+			{
+				factorial *= i;
+			}
+			
+			for(int i = 0; i <= p; i++)
+			{
+				for(int k = 0; k <= p; k++)
+				{
+					float sum = 0;
+					for(int j = i; j <= p; j++)
+					{
+						const float sign = (j - i) % 2 == 0 ? 1.0 : -1.0;
+						float power = 1;
+						for(int e = 0; e < p - k; e++)
+						{
+							power *= p - j;
+						}
+						
+						sum += sign * get_binomial(p + 1, j - i) * power;
+					}
+					
+					uniform_matrices[offset + i * (p + 1) + k] = get_binomial(p, k) / factorial * sum;
+				}
+			}
+		}
+	}
+	
+	/** Calculates the position and the first derivative with respect to `u` at the given span using `calc_basis_der`. */
+	private void eval_point_derivative(
+		const int degree, const int v_count, const int span, const float u,
+		float &out x, float &out y, float &out dx, float &out dy)
+	{
+		calc_basis_der(degree, span, u);
+		
+		float px = 0, py = 0, pw = 0;
+		float dpx = 0, dpy = 0, dpw = 0;
+		
+		for(int i = 0; i <= degree; i++)
+		{
+			const int j = span - degree + i;
+			if(j < 0 || j >= v_count)
+				continue;
+			
+			CurvePointW@ p = vertices_weighted[j];
+			const float ni = basis_list[i];
+			const float dni = basis_der_list[i];
+			px += p.x * ni;
+			py += p.y * ni;
+			pw += p.w * ni;
+			dpx += p.x * dni;
+			dpy += p.y * dni;
+			dpw += p.w * dni;
+		}
+		
+		// Convert back to cartesian coordinates.
+		if(pw != 0)
+		{
+			x = px / pw;
+			y = py / pw;
+			dx = (dpx - x * dpw) / pw;
+			dy = (dpy - y * dpw) / pw;
+		}
+		else
+		{
+			x = px;
+			y = py;
+			dx = dpx;
+			dy = dpy;
+		}
+		
+		last_w = pw;
+	}
+	
 	private void calc_der_basis(const int degree, const int span, const float u, const int num_ders)
 	{
 		const uint size = degree + 1;
@@ -934,20 +1884,33 @@ class BSpline
 		return multiplicity;
 	}
 	
-	private int calc_binomial(const int n, const int k)
+	/** Returns the binomial coefficient from a lazily built Pascal's triangle. */
+	private int get_binomial(const int n, const int k)
 	{
-		if(k > n)
+		if(k < 0 || k > n)
 			return 0;
 		
-		int result = 1;
-		
-		for(int i = 1; i <= k; ++i)
+		if(n > binomials_n)
 		{
-			result *= (n + 1 - i);
-			result /= i;
+			binomials.resize((n + 1) * (n + 2) / 2);
+			
+			for(int i = binomials_n + 1; i <= n; i++)
+			{
+				const int row = i * (i + 1) / 2;
+				const int prev_row = row - i;
+				binomials[row] = 1;
+				binomials[row + i] = 1;
+				
+				for(int j = 1; j < i; j++)
+				{
+					binomials[row + j] = binomials[prev_row + j - 1] + binomials[prev_row + j];
+				}
+			}
+			
+			binomials_n = n;
 		}
 		
-		return result;
+		return binomials[n * (n + 1) / 2 + k];
 	}
 	
 	private void ensure_array_2(array<array<float>>@ arr, const uint n1, const uint n2)
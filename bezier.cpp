@@ -0,0 +1,142 @@
+namespace Bezier
+{
+	
+	/** Calculate the position at the given t value for a rational bezier curve of any degree.
+	  * The control points are `points[offset]` to `points[offset + degree]`, and each point's `w` is its weight.
+	  * Uses a Horner style evaluation of the Bernstein polynomials, so no scratch storage is needed.
+	  * @param w Receives the weight/ratio at t. */
+	void eval_point(
+		array<CurvePointW>@ points, const int offset, const int degree,
+		const float t, float &out x, float &out y, float &out w)
+	{
+		_eval_homogeneous(points, offset, degree, t, x, y, w);
+		
+		if(w != 0)
+		{
+			x /= w;
+			y /= w;
+		}
+	}
+	
+	/** Calculate the position and first derivative at the given t value for a rational bezier curve of any degree.
+	  * See `eval_point`. */
+	void eval(
+		array<CurvePointW>@ points, const int offset, const int degree,
+		const float t, float &out x, float &out y, float &out dx, float &out dy, float &out w)
+	{
+		_eval_homogeneous(points, offset, degree, t, x, y, w);
+		
+		// The derivative of a bezier is a bezier of one lower degree over the differences of its control points.
+		float hx = 0, hy = 0, hw = 0;
+		if(degree >= 1)
+		{
+			const int n = degree - 1;
+			const float u = 1 - t;
+			float bc = 1;
+			float tn = 1;
+			
+			CurvePointW@ p0 = @points[offset];
+			CurvePointW@ p1 = @points[offset + 1];
+			float qx = p1.x * p1.w - p0.x * p0.w;
+			float qy = p1.y * p1.w - p0.y * p0.w;
+			float qw = p1.w - p0.w;
+			
+			if(n == 0)
+			{
+				hx = qx;
+				hy = qy;
+				hw = qw;
+			}
+			else
+			{
+				hx = qx * u;
+				hy = qy * u;
+				hw = qw * u;
+				
+				for(int i = 1; i <= n; i++)
+				{
+					@p0 = @p1;
+					@p1 = @points[offset + i + 1];
+					qx = p1.x * p1.w - p0.x * p0.w;
+					qy = p1.y * p1.w - p0.y * p0.w;
+					qw = p1.w - p0.w;
+					
+					tn *= t;
+					bc = bc * (n - i + 1) / i;
+					
+					if(i < n)
+					{
+						hx = (hx + tn * bc * qx) * u;
+						hy = (hy + tn * bc * qy) * u;
+						hw = (hw + tn * bc * qw) * u;
+					}
+					else
+					{
+						hx += tn * qx;
+						hy += tn * qy;
+						hw += tn * qw;
+					}
+				}
+			}
+			
+			hx *= degree;
+			hy *= degree;
+			hw *= degree;
+		}
+		
+		if(w != 0)
+		{
+			x /= w;
+			y /= w;
+			dx = (hx - x * hw) / w;
+			dy = (hy - y * hw) / w;
+		}
+		else
+		{
+			dx = hx;
+			dy = hy;
+		}
+	}
+	
+	/** Internal method - evaluates the weighted/homogeneous point at t. */
+	void _eval_homogeneous(
+		array<CurvePointW>@ points, const int offset, const int degree,
+		const float t, float &out x, float &out y, float &out w)
+	{
+		CurvePointW@ p = @points[offset];
+		
+		if(degree <= 0)
+		{
+			x = p.x * p.w;
+			y = p.y * p.w;
+			w = p.w;
+			return;
+		}
+		
+		const float u = 1 - t;
+		float bc = 1;
+		float tn = 1;
+		
+		x = p.x * p.w * u;
+		y = p.y * p.w * u;
+		w = p.w * u;
+		
+		for(int i = 1; i < degree; i++)
+		{
+			@p = @points[offset + i];
+			tn *= t;
+			bc = bc * (degree - i + 1) / i;
+			const float f = tn * bc * p.w;
+			x = (x + f * p.x) * u;
+			y = (y + f * p.y) * u;
+			w = (w + f) * u;
+		}
+		
+		@p = @points[offset + degree];
+		const float f = tn * t * p.w;
+		x += f * p.x;
+		y += f * p.y;
+		w += f;
+	}
+	
+}
@@ -1,14 +1,17 @@
-#include 'EvalFunc.cpp';
+#include 'CurveKernel.cpp';
 
 namespace Curve
 {
 	
 	/** Subdivides a curve using the given eval func. Each `CurveVertex` is considered a separate segment of the curve,
-	  * and the results are stored in the `length` and `arcs` property of each vertex.
+	  * and the results are stored in `arcs`, with each vertex's `length`, `arc_offset`, and `arc_count` properties referencing them.
+	  * Arc lengths are stored relative to the start of each segment so that segments that have not changed never need to be updated.
+	  * Use a `CurveLengthIndex` to find the distance to the start of any segment.
 	  * @param vertices The vertices defining a curve made up of multiple segments.
 	  * @param vertex_count The number of vertices.
 	  * @param closed Is the curve closed or open.
-	  * @param eval The curve evaluation function.
+	  * @param arcs The packed store the arcs for all segments will be written to.
+	  * @param kernel Evaluates the curve.
 	  * @param only_invalidated If true, only vertices with the `invalidate` field set to true will be recalculated.
 	  * @param division_count How many sections each segment/vertex will be broken into. The highter this number the more accurate the results.
 	  * @param angle_min If > 0, will subdivide each arc segment if the angle between the start and end of the segment is greater than this angle (radians).
@@ -22,15 +25,20 @@ namespace Curve
 	  *   Can help improve accuracy around tight corners without increasing the resolution or adaptive parameters a lot.
 	  * @param length_max If > 0 segments larger than this will subdivide regardless `max_subdivisions`. Not recommended as the number of subdivisions will be proportional
 	  *   to the length of the curve, but will ensure a more even distribution regardless.
+	  * @param segments If set, the initial uniform divisions of any non-rational segments will be calculated with a `CurveStepper`
+	  *   instead of `eval`.
 	  * @return The total length of the curve. */
 	float calculate_arc_lengths(
 		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
-		EvalFunc@ eval, const bool only_invalidated, const int division_count,
+		CurveArcs@ arcs,
+		CurveKernel@ kernel, const bool only_invalidated, const int division_count,
 		const float angle_min=0, const float max_stretch_factor=0,
 		const float length_min=0, const int max_subdivisions=0,
-		const float angle_max=0, const float length_max=0)
+		const float angle_max=0, const float length_max=0,
+		array<CurveSegment>@ segments=null)
 	{
 		float total_length = 0;
+		CurveStepper stepper;
 		
 		const int v_count = closed ? vertex_count - 1 : vertex_count - 2;
 		for(int i = 0; i <= v_count; i++)
@@ -43,14 +51,10 @@ namespace Curve
 				continue;
 			}
 			
-			array<CurveArc>@ arcs = @v.arcs;
-			uint arc_count = 0;
-			v.length = total_length;
+			const int arc_start = arcs.size;
+			float segment_length = 0;
 			
-			while(division_count >= int(arcs.length))
-			{
-				arcs.resize(arcs.length < 8 ? 8 : arcs.length * 2);
-			}
+			arcs.reserve(division_count + 1);
 			
 			float t1 = 0;
 			float x1 = 0;
@@ -62,47 +66,47 @@ namespace Curve
 			float t_length = 0;
 			float dx = 0, dy = 0, nx = 0, ny = 0;
 			
+			const bool stepping = segments !is null && stepper.start(segments[i], division_count);
+			
 			for(int j = 0; j <= division_count; j++)
 			{
 				const float t2 = float(j) / division_count;
 				
 				float x2, y2;
 				float n2x, n2y;
-				eval(i, t2, x2, y2, n2x, n2y);
+				if(stepping)
+				{
+					x2 = stepper.x;
+					y2 = stepper.y;
+					n2x = stepper.normal_x;
+					n2y = stepper.normal_y;
+					stepper.step();
+				}
+				else
+				{
+					kernel.eval(i, t2, x2, y2, n2x, n2y);
+				}
 				
 				if(j > 0)
 				{
-					arc_count = _add_arc_length(
-						eval, arcs, arc_count,
+					_add_arc_length(
+						kernel, arcs,
 						i, t1, t2,
 						x1, y1, n1x, n1y,
 						x2, y2, n2x, n2y,
-						total_length,
+						segment_length,
 						angle_min, max_stretch_factor,
 						length_min,
 						angle_min > 0 || length_min > 0 || max_stretch_factor > 0 ? max_subdivisions : 0,
 						angle_max, length_max,
-						arc_length_sqr, arc_length, total_length, t_length,
+						arc_length_sqr, arc_length, segment_length, t_length,
 						dx, dy, nx, ny);
 				}
 				
-				if(arc_count + 1 >= arcs.length)
-				{
-					arcs.resize(arcs.length * 2);
-				}
-				
-				CurveArc@ arc = @arcs[arc_count++];
-				arc.t = t2;
-				arc.x = x2;
-				arc.y = y2;
-				arc.length_sqr = arc_length_sqr;
-				arc.length = arc_length;
-				arc.total_length = total_length;
-				arc.t_length = t_length;
-				arc.dx = dx;
-				arc.dy = dy;
-				arc.nx = nx;
-				arc.ny = ny;
+				arcs.add(
+					t2, x2, y2,
+					dx, dy, nx, ny,
+					arc_length_sqr, arc_length, segment_length, t_length);
 				
 				t1 = t2;
 				x1 = x2;
@@ -111,16 +115,36 @@ namespace Curve
 				n1y = n2y;
 			}
 			
-			v.arc_count = int(arc_count);
-			v.length = total_length - v.length;
+			arcs.commit(v, arc_start);
+			v.length = segment_length;
+			total_length += segment_length;
 		}
 		
+		arcs.compact(vertices, vertex_count, v_count + 1);
+		
 		return total_length;
 	}
 	
+	/** Same as the `CurveKernel` version, but evaluates the curve through an `EvalFunc` delegate. */
+	float calculate_arc_lengths(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
+		CurveArcs@ arcs,
+		EvalFunc@ eval, const bool only_invalidated, const int division_count,
+		const float angle_min=0, const float max_stretch_factor=0,
+		const float length_min=0, const int max_subdivisions=0,
+		const float angle_max=0, const float length_max=0,
+		array<CurveSegment>@ segments=null)
+	{
+		return calculate_arc_lengths(
+			vertices, vertex_count, closed, arcs,
+			CurveFuncKernel(eval, null, null), only_invalidated, division_count,
+			angle_min, max_stretch_factor, length_min, max_subdivisions,
+			angle_max, length_max, segments);
+	}
+	
 	/** Internal method - recursively subdivides and adds arc segments between t1 and t2. */
-	uint _add_arc_length(
-		EvalFunc@ eval, array<CurveArc>@ arcs, uint arc_count,
+	void _add_arc_length(
+		CurveKernel@ kernel, CurveArcs@ arcs,
 		const int segment_index, const float t1, const float t2,
 		const float x1, const float y1, const float n1x, const float n1y,
 		const float x2, const float y2, const float n2x, const float n2y,
@@ -158,22 +182,22 @@ namespace Curve
 		if(!subdivide)
 		{
 			if(out_arc_length == 0 || max_stretch_factor <= 0 || closeTo(tm, t2))
-				return arc_count;
+				return;
 			
-			eval(segment_index, tm, mx, my, nmx, nmy);
+			kernel.eval(segment_index, tm, mx, my, nmx, nmy);
 			const float real_length = sqrt((mx - x1) * (mx - x1) + (my - y1) * (my - y1));
 			
 			if(abs(real_length - out_arc_length * 0.5) / (out_arc_length * 0.5) < max_stretch_factor)
-				return arc_count;
+				return;
 		}
 		else
 		{
-			eval(segment_index, tm, mx, my, nmx, nmy);
+			kernel.eval(segment_index, tm, mx, my, nmx, nmy);
 		}
 		
 		// Subdivide the left.
-		arc_count = _add_arc_length(
-			eval, arcs, arc_count,
+		_add_arc_length(
+			kernel, arcs,
 			segment_index, t1, tm,
 			x1, y1, n1x, n1y,
 			mx, my, nmx, nmy,
@@ -185,28 +209,14 @@ namespace Curve
 			out_dx, out_dy, out_nx, out_ny);
 		
 		// Add the mid point.
-		
-		if(arc_count + 1 >= arcs.length)
-		{
-			arcs.resize(arcs.length * 2);
-		}
-		
-		CurveArc@ arc = @arcs[arc_count++];
-		arc.t = tm;
-		arc.x = mx;
-		arc.y = my;
-		arc.length_sqr = out_arc_length_sqr;
-		arc.length = out_arc_length;
-		arc.total_length = out_total_length;
-		arc.t_length = out_t_length;
-		arc.dx = out_dx;
-		arc.dy = out_dy;
-		arc.nx = out_nx;
-		arc.ny = out_ny;
+		arcs.add(
+			tm, mx, my,
+			out_dx, out_dy, out_nx, out_ny,
+			out_arc_length_sqr, out_arc_length, out_total_length, out_t_length);
 		
 		// Subdivide the right.
-		arc_count = _add_arc_length(
-			eval, arcs, arc_count,
+		_add_arc_length(
+			kernel, arcs,
 			segment_index, tm, t2,
 			mx, my, nmx, nmy,
 			x2, y2, n2x, n2y,
@@ -216,8 +226,6 @@ namespace Curve
 			angle_max, length_max,
 			out_arc_length_sqr, out_arc_length, out_total_length, out_t_length,
 			out_dx, out_dy, out_nx, out_ny);
-		
-		return arc_count;
 	}
 	
 }
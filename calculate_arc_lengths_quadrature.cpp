@@ -0,0 +1,191 @@
+#include 'CurveKernel.cpp';
+
+namespace Curve
+{
+	
+	/** Calculates the same arcs and lengths as `calculate_arc_lengths`, but instead of measuring chords of an adaptively subdivided curve,
+	  * each segment is split into `division_count` uniform divisions and the length of each division is found by integrating the speed
+	  * of the curve (the length of its first derivative) with adaptive Gauss-Legendre quadrature.
+	  * The arc positions are still stored so that `closest_point`, etc. work as normal, but the `length` and `total_length` of each arc
+	  * are the integrated lengths, not the chord lengths.
+	  * Each segment costs `division_count + 1` position evaluations, and 7 derivative evaluations per division, plus 14 more each time a
+	  * division is halved. Lowering `division_count` reduces the number of evaluations, at the cost of coarser arcs for `closest_point`, etc.
+	  * @param vertices The vertices defining a curve made up of multiple segments.
+	  * @param vertex_count The number of vertices.
+	  * @param closed Is the curve closed or open.
+	  * @param arcs The packed store the arcs for all segments will be written to.
+	  * @param kernel Evaluates the position of each arc, and the derivative used to integrate the length of each arc.
+	  * @param only_invalidated If true, only vertices with the `invalidate` field set to true will be recalculated.
+	  * @param division_count How many uniform sections each segment/vertex will be broken into.
+	  * @param tolerance The maximum allowed estimated error per segment in world units. Divisions that exceed their share are halved and
+	  *   integrated again.
+	  * @param max_depth How many times each division is allowed to be halved.
+	  * @param length_error Receives the sum of the estimated errors of each segment. Each vertex's `length_error` receives the estimated
+	  *   error of its segment. The estimate is based on the difference between a 3 and 5 point rule, so the real error is usually much smaller.
+	  * @return The total length of the curve. */
+	float calculate_arc_lengths_quadrature(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
+		CurveArcs@ arcs,
+		CurveKernel@ kernel,
+		const bool only_invalidated, const int division_count,
+		const float tolerance, const int max_depth,
+		float &out length_error)
+	{
+		float total_length = 0;
+		length_error = 0;
+		
+		const int divisions = division_count > 0 ? division_count : 1;
+		const float division_tolerance = tolerance / divisions;
+		
+		const int v_count = closed ? vertex_count - 1 : vertex_count - 2;
+		for(int i = 0; i <= v_count; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			
+			if(only_invalidated && !v.invalidated)
+			{
+				total_length += v.length;
+				length_error += v.length_error;
+				continue;
+			}
+			
+			const int arc_start = arcs.size;
+			float segment_length = 0;
+			float segment_error = 0;
+			
+			arcs.reserve(divisions + 1);
+			
+			float t1 = 0;
+			float x1 = 0;
+			float y1 = 0;
+			
+			for(int j = 0; j <= divisions; j++)
+			{
+				const float t2 = float(j) / divisions;
+				
+				float x2, y2;
+				kernel.eval_point(i, t2, x2, y2);
+				
+				float dx = 0, dy = 0, nx = 0, ny = 0;
+				float chord_length_sqr = 0, arc_length = 0;
+				
+				if(j > 0)
+				{
+					dx = x2 - x1;
+					dy = y2 - y1;
+					if(is_nan(dx)) dx = 0;
+					if(is_nan(dy)) dy = 0;
+					chord_length_sqr = dx * dx + dy * dy;
+					const float chord_length = sqrt(chord_length_sqr);
+					nx = chord_length != 0 ? dy / chord_length : 0.0;
+					ny = chord_length != 0 ? -dx / chord_length : 0.0;
+					
+					float error;
+					arc_length = _integrate_length(kernel, i, t1, t2, division_tolerance, max_depth, error);
+					
+					// An arc can never be shorter than its chord.
+					if(is_nan(arc_length) || arc_length < chord_length)
+					{
+						arc_length = chord_length;
+					}
+					
+					segment_length += arc_length;
+					segment_error += error;
+				}
+				
+				arcs.add(
+					t2, x2, y2,
+					dx, dy, nx, ny,
+					chord_length_sqr, arc_length, segment_length, t2 - t1);
+				
+				t1 = t2;
+				x1 = x2;
+				y1 = y2;
+			}
+			
+			arcs.commit(v, arc_start);
+			v.length = segment_length;
+			v.length_error = segment_error;
+			total_length += segment_length;
+			length_error += segment_error;
+		}
+		
+		arcs.compact(vertices, vertex_count, v_count + 1);
+		
+		return total_length;
+	}
+	
+	/** Same as the `CurveKernel` version, but evaluates the curve through `EvalPointFunc` and `EvalDerivativeFunc` delegates. */
+	float calculate_arc_lengths_quadrature(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
+		CurveArcs@ arcs,
+		EvalPointFunc@ eval_point, EvalDerivativeFunc@ eval_derivative,
+		const bool only_invalidated, const int division_count,
+		const float tolerance, const int max_depth,
+		float &out length_error)
+	{
+		return calculate_arc_lengths_quadrature(
+			vertices, vertex_count, closed, arcs,
+			CurveFuncKernel(null, eval_point, eval_derivative),
+			only_invalidated, division_count, tolerance, max_depth,
+			length_error);
+	}
+	
+	/** Internal method - integrates the speed of the curve between t1 and t2, halving the interval until the difference between
+	  * the 5 and 3 point rules is within `tolerance`. */
+	float _integrate_length(
+		CurveKernel@ kernel, const int segment_index,
+		const float t1, const float t2, const float tolerance, const int depth,
+		float &out error)
+	{
+		float length5, length3;
+		_gauss_legendre_length(kernel, segment_index, t1, t2, length5, length3);
+		
+		error = abs(length5 - length3);
+		if(depth <= 0 || error <= tolerance)
+			return length5;
+		
+		const float tm = (t1 + t2) * 0.5;
+		float error_left, error_right;
+		const float length =
+			_integrate_length(kernel, segment_index, t1, tm, tolerance * 0.5, depth - 1, error_left) +
+			_integrate_length(kernel, segment_index, tm, t2, tolerance * 0.5, depth - 1, error_right);
+		error = error_left + error_right;
+		
+		return length;
+	}
+	
+	/** Internal method - calculates the 5 and 3 point Gauss-Legendre estimates of the length between t1 and t2.
+	  * Both rules share the mid point, so this requires 7 derivative evaluations. */
+	void _gauss_legendre_length(
+		CurveKernel@ kernel, const int segment_index,
+		const float t1, const float t2,
+		float &out length5, float &out length3)
+	{
+		const float h = (t2 - t1) * 0.5;
+		const float tm = (t1 + t2) * 0.5;
+		
+		const float s0 = _speed(kernel, segment_index, tm);
+		const float s1 =
+			_speed(kernel, segment_index, tm - h * 0.5384693101) +
+			_speed(kernel, segment_index, tm + h * 0.5384693101);
+		const float s2 =
+			_speed(kernel, segment_index, tm - h * 0.9061798459) +
+			_speed(kernel, segment_index, tm + h * 0.9061798459);
+		const float s3 =
+			_speed(kernel, segment_index, tm - h * 0.7745966692) +
+			_speed(kernel, segment_index, tm + h * 0.7745966692);
+		
+		length5 = h * (0.5688888889 * s0 + 0.4786286705 * s1 + 0.2369268851 * s2);
+		length3 = h * (0.8888888889 * s0 + 0.5555555556 * s3);
+	}
+	
+	/** Internal method - returns the length of the derivative at t. */
+	float _speed(CurveKernel@ kernel, const int segment_index, const float t)
+	{
+		float dx, dy;
+		kernel.eval_derivative(segment_index, t, dx, dy);
+		return sqrt(dx * dx + dy * dy);
+	}
+	
+}
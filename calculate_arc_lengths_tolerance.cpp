@@ -0,0 +1,173 @@
+#include 'CurveKernel.cpp';
+
+namespace Curve
+{
+	
+	/** Calculates the same arcs and lengths as `calculate_arc_lengths`, but instead of relying on fixed divisions and angle heuristics,
+	  * each segment is recursively subdivided until the curve deviates from each arc's chord by no more than `tolerance` in world units.
+	  * The number of arcs therefore depends on how curved and how large each segment is.
+	  * The deviation is bounded using the cubic Bezier control polygon built from the position and first derivative at each end of an arc.
+	  * This is exact for linear, quadratic, cubic, and Catmull-Rom segments. For rational and b-spline segments it is an estimate.
+	  * @param vertices The vertices defining a curve made up of multiple segments.
+	  * @param vertex_count The number of vertices.
+	  * @param closed Is the curve closed or open.
+	  * @param arcs The packed store the arcs for all segments will be written to.
+	  * @param kernel Evaluates the position and derivative of the curve.
+	  * @param only_invalidated If true, only vertices with the `invalidate` field set to true will be recalculated.
+	  * @param tolerance The maximum allowed distance between the curve and any arc.
+	  * @param max_subdivisions How many times each segment can be halved. Arcs will not meet the tolerance if this is reached.
+	  * @param max_deviation Receives the largest deviation bound of any arc. Each vertex's `arc_deviation` receives the largest
+	  *   deviation bound of its segment.
+	  * @return The total length of the curve. */
+	float calculate_arc_lengths_tolerance(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
+		CurveArcs@ arcs,
+		CurveKernel@ kernel,
+		const bool only_invalidated, const float tolerance, const int max_subdivisions,
+		float &out max_deviation)
+	{
+		float total_length = 0;
+		max_deviation = 0;
+		
+		const int v_count = closed ? vertex_count - 1 : vertex_count - 2;
+		for(int i = 0; i <= v_count; i++)
+		{
+			CurveVertex@ v = vertices[i];
+			
+			if(only_invalidated && !v.invalidated)
+			{
+				total_length += v.length;
+				if(v.arc_deviation > max_deviation)
+				{
+					max_deviation = v.arc_deviation;
+				}
+				continue;
+			}
+			
+			const int arc_start = arcs.size;
+			float segment_length = 0;
+			float segment_deviation = 0;
+			
+			float x1, y1, d1x, d1y;
+			float x2, y2, d2x, d2y;
+			kernel.eval_point(i, 0, x1, y1);
+			kernel.eval_derivative(i, 0, d1x, d1y);
+			kernel.eval_point(i, 1, x2, y2);
+			kernel.eval_derivative(i, 1, d2x, d2y);
+			
+			arcs.add(0, x1, y1, 0, 0, 0, 0, 0, 0, 0, 0);
+			
+			_add_arc_tolerance(
+				kernel, arcs,
+				i, 0, 1,
+				x1, y1, d1x, d1y,
+				x2, y2, d2x, d2y,
+				0, 0,
+				tolerance, max_subdivisions,
+				segment_length, segment_deviation);
+			
+			arcs.commit(v, arc_start);
+			v.length = segment_length;
+			v.arc_deviation = segment_deviation;
+			total_length += segment_length;
+			
+			if(segment_deviation > max_deviation)
+			{
+				max_deviation = segment_deviation;
+			}
+		}
+		
+		arcs.compact(vertices, vertex_count, v_count + 1);
+		
+		return total_length;
+	}
+	
+	/** Same as the `CurveKernel` version, but evaluates the curve through `EvalPointFunc` and `EvalDerivativeFunc` delegates. */
+	float calculate_arc_lengths_tolerance(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
+		CurveArcs@ arcs,
+		EvalPointFunc@ eval_point, EvalDerivativeFunc@ eval_derivative,
+		const bool only_invalidated, const float tolerance, const int max_subdivisions,
+		float &out max_deviation)
+	{
+		return calculate_arc_lengths_tolerance(
+			vertices, vertex_count, closed, arcs,
+			CurveFuncKernel(null, eval_point, eval_derivative),
+			only_invalidated, tolerance, max_subdivisions,
+			max_deviation);
+	}
+	
+	/** Internal method - adds the arc ending at t2 if the curve between t1 and t2 is within `tolerance` of the chord, or otherwise
+	  * splits it in half and recurses. */
+	void _add_arc_tolerance(
+		CurveKernel@ kernel, CurveArcs@ arcs,
+		const int segment_index, const float t1, const float t2,
+		const float x1, const float y1, const float d1x, const float d1y,
+		const float x2, const float y2, const float d2x, const float d2y,
+		const float total_length, const float max_deviation,
+		const float tolerance, const int max_subdivisions,
+		float &out out_total_length, float &out out_max_deviation)
+	{
+		float dx = x2 - x1;
+		float dy = y2 - y1;
+		if(is_nan(dx)) dx = 0;
+		if(is_nan(dy)) dy = 0;
+		const float length_sqr = dx * dx + dy * dy;
+		const float length = sqrt(length_sqr);
+		
+		// The inner control points of the equivalent cubic bezier, relative to the start.
+		const float h = (t2 - t1) / 3;
+		const float c1x = d1x * h;
+		const float c1y = d1y * h;
+		const float c2x = dx - d2x * h;
+		const float c2y = dy - d2y * h;
+		
+		// The curve lies within 3/4 of the furthest control point's distance from the chord.
+		float deviation;
+		if(length != 0)
+		{
+			deviation = max(abs(c1x * dy - c1y * dx), abs(c2x * dy - c2y * dx)) / length;
+		}
+		else
+		{
+			deviation = sqrt(max(c1x * c1x + c1y * c1y, c2x * c2x + c2y * c2y));
+		}
+		deviation *= 0.75;
+		
+		if(is_nan(deviation) || deviation <= tolerance || max_subdivisions <= 0)
+		{
+			out_total_length = total_length + length;
+			out_max_deviation = deviation > max_deviation ? deviation : max_deviation;
+			
+			arcs.add(
+				t2, x2, y2,
+				dx, dy,
+				length != 0 ? dy / length : 0.0, length != 0 ? -dx / length : 0.0,
+				length_sqr, length, out_total_length, t2 - t1);
+			return;
+		}
+		
+		const float tm = (t1 + t2) * 0.5;
+		float mx, my, dmx, dmy;
+		kernel.eval_point(segment_index, tm, mx, my);
+		kernel.eval_derivative(segment_index, tm, dmx, dmy);
+		
+		_add_arc_tolerance(
+			kernel, arcs,
+			segment_index, t1, tm,
+			x1, y1, d1x, d1y,
+			mx, my, dmx, dmy,
+			total_length, max_deviation,
+			tolerance, max_subdivisions - 1,
+			out_total_length, out_max_deviation);
+		_add_arc_tolerance(
+			kernel, arcs,
+			segment_index, tm, t2,
+			mx, my, dmx, dmy,
+			x2, y2, d2x, d2y,
+			out_total_length, out_max_deviation,
+			tolerance, max_subdivisions - 1,
+			out_total_length, out_max_deviation);
+	}
+	
+}
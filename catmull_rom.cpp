@@ -109,4 +109,26 @@ namespace CatmullRom
 		}
 	}
 	
+	/** Calculate the first derivative at the given t value. */
+	void eval_derivative(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y,
+		const float tension,
+		const float t, float &out dx, float &out dy)
+	{
+		const float st = tension * 2;
+		const float t2 = t * t;
+		
+		const float dv1x = (p3x - p1x) / st;
+		const float dv1y = (p3y - p1y) / st;
+		const float dv2x = (p4x - p2x) / st;
+		const float dv2y = (p4y - p2y) / st;
+		
+		const float c0 = 6 * t2 - 6 * t;
+		const float c1 = 3 * t2 - 4 * t + 1;
+		const float c3 = 3 * t2 - 2 * t;
+		dx = c0 * (p2x - p3x) + c1 * dv1x + c3 * dv2x;
+		dy = c0 * (p2y - p3y) + c1 * dv1y + c3 * dv2y;
+	}
+	
 }
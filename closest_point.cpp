@@ -13,18 +13,36 @@ namespace Curve
 	  *   the binary search range on the initial guess.
 	  * @param interpolate_result If true interpolates the t value of the end result which can result in smoother results with larger threshold values.
 	  * @param x1 y1 x2 y2 The bounding box of the curve. Only required when `max_distance` > 0.
+	  * @param arcs The arcs calculated by `calculate_arc_lengths`.
+	  * @param kernel Evaluates the curve. Segments the kernel can solve exactly, e.g. linear and quadratic segments, skip their arcs and the
+	  *   refinement step.
+	  * @param grid If set, only the arcs near the point found with `CurveArcGrid.query` are tested, instead of every arc of every segment.
+	  *   Must have been updated with the same arcs.
+	  * @param candidates If set, and `grid` is not, only these segments are tested, e.g. the segments found by `CurveSegmentBVH.query_rect`.
+	  *   Must be in ascending order.
+	  * @param candidate_count The number of segments in `candidates`.
+	  * @param newton If true, refines the closest arc with Newton iterations on the derivative of the distance, kept within the same bounds
+	  *   as the binary search. Usually converges in a few steps instead of the many needed by the binary search, and the result is not
+	  *   interpolated. Falls back to the binary search if the kernel can't calculate derivatives.
+	  * @param stats If set, the number of iterations and curve evaluations are added to it.
+	  * @param heap_dist heap_segment Scratch arrays used to order the segments, so that they don't need to be allocated for every call.
+	  *   Resized if needed.
 	  * @return true if a point was found within `max_distance` */
 	bool closest_point(
 		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
-		EvalPointFunc@ eval_point,
+		CurveArcs@ arcs,
+		CurveKernel@ kernel,
 		const float x, const float y, int &out segment_index, float &out out_t, float &out out_x, float &out out_y,
 		const float max_distance=0, float threshold=1,
 		const bool arc_length_interpolation=true,
 		const bool adjust_initial_binary_factor=true,
 		const bool interpolate_result=true,
-		const float x1=-INFINITY, const float y1=-INFINITY, const float x2=INFINITY, const float y2=INFINITY)
+		const float x1=-INFINITY, const float y1=-INFINITY, const float x2=INFINITY, const float y2=INFINITY,
+		CurveArcGrid@ grid=null, const array<int>@ candidates=null, const int candidate_count=0,
+		const bool newton=false, CurveClosestPointStats@ stats=null,
+		array<float>@ heap_dist=null, array<int>@ heap_segment=null)
 	{
-		if(vertex_count == 0 || vertices[0].arc_count == 0)
+		if(vertex_count == 0 || arcs.size == 0)
 			return false;
 		
 		const int end = closed ? vertex_count : vertex_count - 1;
@@ -38,15 +56,62 @@ namespace Curve
 		
 		segment_index = -1;
 		int closest_arc_index = -1;
-		CurveArc@ clostest_arc = null;
 		float closest_arc_length = 0;
 		float dist = INFINITY;
 		float dist_interpolated = INFINITY;
+		// The closest distance to a point actually on the curve, which unlike `dist_interpolated` can safely be used to skip segments.
+		float dist_curve = INFINITY;
 		bool is_interpolated = false;
+		bool is_exact = false;
 		float guess_dist = -1;
+		int iterations = 0;
+		int evals = 0;
+		
+		const array<float>@ arc_t = @arcs.t;
+		const array<float>@ arc_x = @arcs.x;
+		const array<float>@ arc_y = @arcs.y;
+		const array<float>@ arc_dx = @arcs.dx;
+		const array<float>@ arc_dy = @arcs.dy;
+		const array<float>@ arc_length = @arcs.length;
+		const array<float>@ arc_length_sqr = @arcs.length_sqr;
+		
+		int segment_count = end;
+		const array<int>@ segment_list = null;
+		
+		if(grid !is null)
+		{
+			segment_count = grid.query(vertices, arcs, x, y, max_distance);
+			@segment_list = @grid.candidate_segments;
+		}
+		else if(candidates !is null)
+		{
+			segment_count = candidate_count;
+			@segment_list = @candidates;
+		}
+		
+		// Visit the segments in order of the distance to their bounding box, so that the search can stop as soon as the next bounding box
+		// is farther away than the closest point found so far.
+		if(heap_dist is null)
+		{
+			@heap_dist = array<float>();
+		}
+		if(heap_segment is null)
+		{
+			@heap_segment = array<int>();
+		}
+		if(int(heap_dist.length) < segment_count)
+		{
+			heap_dist.resize(segment_count);
+		}
+		if(int(heap_segment.length) < segment_count)
+		{
+			heap_segment.resize(segment_count);
+		}
+		int heap_size = 0;
 		
-		for(int i = 0; i < end; i++)
+		for(int si = 0; si < segment_count; si++)
 		{
+			const int i = segment_list !is null ? segment_list[si] : si;
 			CurveVertex@ v = vertices[i];
 			
 			if(max_distance > 0 && (
@@ -54,32 +119,82 @@ namespace Curve
 				y < v.y1 - max_distance || y > v.y2 + max_distance))
 				continue;
 			
+			const float bx = x < v.x1 ? v.x1 - x : x > v.x2 ? x - v.x2 : 0.0;
+			const float by = y < v.y1 ? v.y1 - y : y > v.y2 ? y - v.y2 : 0.0;
+			heap_dist[heap_size] = bx * bx + by * by;
+			heap_segment[heap_size] = i;
+			heap_size++;
+		}
+		
+		for(int hi = heap_size / 2 - 1; hi >= 0; hi--)
+		{
+			_heap_sift_down(heap_dist, heap_segment, heap_size, hi);
+		}
+		
+		while(heap_size > 0 && heap_dist[0] <= dist_curve)
+		{
+			const int i = heap_segment[0];
+			CurveVertex@ v = vertices[i];
+			
+			heap_size--;
+			heap_dist[0] = heap_dist[heap_size];
+			heap_segment[0] = heap_segment[heap_size];
+			_heap_sift_down(heap_dist, heap_segment, heap_size, 0);
+			
+			// Segments with a closed form solution don't need their arcs to be tested.
+			float e_t, e_x, e_y;
+			if(kernel.closest_point(i, x, y, e_t, e_x, e_y))
+			{
+				const float e_dist = (x - e_x) * (x - e_x) + (y - e_y) * (y - e_y);
+				dist_curve = min(dist_curve, e_dist);
+				if(e_dist < dist_interpolated)
+				{
+					is_exact = true;
+					out_t = e_t;
+					out_x = e_x;
+					out_y = e_y;
+					segment_index = i;
+					dist = e_dist;
+					dist_interpolated = e_dist;
+				}
+				continue;
+			}
+			
 			// Start at 1 because the starting point of this segment is the same as the end point of the previous,
 			// which has already been tested.
+			const int o = v.arc_offset;
 			for(int j = i > 0 && closed ? 1 : 0; j < v.arc_count; j++)
 			{
-				CurveArc@ c = v.arcs[j];
+				const int k = o + j;
+				if(grid !is null && !grid.is_candidate(k))
+					continue;
+				
+				const float c_dx = arc_dx[k];
+				const float c_dy = arc_dy[k];
 				float c_dist_interpolated = INFINITY;
 				float c_guess_dist = -1;
-				float c_length = c.length;
-				float c_x = c.x;
-				float c_y = c.y;
-				float c_t = c.t;
+				float c_length = arc_length[k];
+				float c_x = arc_x[k];
+				float c_y = arc_y[k];
+				float c_t = arc_t[k];
 				
 				// Project the point onto the current arc segment to find a more accurate initial guess.
-				if(arc_length_interpolation && j > 0 && (c.dx != 0 || c.dy != 0))
+				if(arc_length_interpolation && j > 0 && (c_dx != 0 || c_dy != 0))
 				{
-					CurveArc@ c0 = v.arcs[j - 1];
-					float arc_local_t = ((x - c0.x) * c.dx + (y - c0.y) * c.dy) / c.length_sqr;
+					const float c0x = arc_x[k - 1];
+					const float c0y = arc_y[k - 1];
+					const float c0t = arc_t[k - 1];
+					float arc_local_t = ((x - c0x) * c_dx + (y - c0y) * c_dy) / arc_length_sqr[k];
 					
 					if(arc_local_t > 0 && arc_local_t < 1)
 					{
-						const float linear_x = c0.x + c.dx * arc_local_t;
-						const float linear_y = c0.y + c.dy * arc_local_t;
-						float arc_t = c0.t + (c.t - c0.t) * arc_local_t;
+						const float linear_x = c0x + c_dx * arc_local_t;
+						const float linear_y = c0y + c_dy * arc_local_t;
+						float arc_t = c0t + (c_t - c0t) * arc_local_t;
 						
 						float arc_x, arc_y;
-						eval_point(i, arc_t, arc_x, arc_y);
+						kernel.eval_point(i, arc_t, arc_x, arc_y);
+						evals++;
 						
 						// Take the interpolated curve point (which could be farther away) and project it back onto the
 						// perpendicular line from the closest linear point to get something that's hopefully closer to the curve and desired point.
@@ -114,11 +229,13 @@ namespace Curve
 				}
 				
 				const float c_dist = (x - c_x) * (x - c_x) + (y - c_y) * (y - c_y);
+				dist_curve = min(dist_curve, c_dist);
 				
 				if((c_dist_interpolated < c_dist ? c_dist_interpolated : c_dist) > dist_interpolated)
 					continue;
 				
 				is_interpolated = c_dist_interpolated != INFINITY;
+				is_exact = false;
 				
 				out_t = c_t;
 				out_x = c_x;
@@ -133,7 +250,77 @@ namespace Curve
 		}
 		
 		if(segment_index == -1)
+		{
+			if(stats !is null)
+			{
+				stats.add(iterations, evals);
+			}
 			return false;
+		}
+		
+		if(is_exact)
+		{
+			if(stats !is null)
+			{
+				stats.add(iterations, evals);
+			}
+			
+			return max_distance <= 0 || dist <= max_distance * max_distance;
+		}
+		
+		int refine_iterations, refine_evals;
+		const bool found = _closest_point_refine(
+			vertices, vertex_count, closed, arcs, kernel, x, y,
+			segment_index, closest_arc_index, closest_arc_length, is_interpolated, guess_dist,
+			out_t, out_x, out_y, dist,
+			max_distance, threshold,
+			arc_length_interpolation,
+			adjust_initial_binary_factor,
+			interpolate_result,
+			newton,
+			segment_index, out_t, out_x, out_y, refine_iterations, refine_evals);
+		
+		if(stats !is null)
+		{
+			stats.add(iterations + refine_iterations, evals + refine_evals);
+		}
+		
+		return found;
+	}
+	
+	/** Internal method - step 2 of `closest_point`. Refines the closest point found on the arcs by searching the curve around it.
+	  * @param closest_segment closest_arc_index closest_arc_length The segment, index within the segment, and length of the closest arc.
+	  * @param is_interpolated True if `t`, `px`, and `py` were interpolated between the closest arc and the one before it.
+	  * @param guess_dist The squared distance between the interpolated point and its projection. Only used when `is_interpolated` is true.
+	  * @param t px py dist The segment t value, position, and squared distance of the closest point found so far.
+	  * @return true if a point was found within `max_distance` */
+	bool _closest_point_refine(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
+		CurveArcs@ arcs,
+		CurveKernel@ kernel,
+		const float x, const float y,
+		const int closest_segment, const int closest_arc_index, const float closest_arc_length,
+		const bool is_interpolated, const float guess_dist,
+		const float t, const float px, const float py, float dist,
+		const float max_distance, float threshold,
+		const bool arc_length_interpolation,
+		const bool adjust_initial_binary_factor,
+		const bool interpolate_result,
+		const bool newton,
+		int &out segment_index, float &out out_t, float &out out_x, float &out out_y, int &out iterations, int &out evals)
+	{
+		segment_index = closest_segment;
+		out_t = t;
+		out_x = px;
+		out_y = py;
+		iterations = 0;
+		evals = 0;
+		
+		const int end = closed ? vertex_count : vertex_count - 1;
+		
+		const array<float>@ arc_t = @arcs.t;
+		const array<float>@ arc_x = @arcs.x;
+		const array<float>@ arc_y = @arcs.y;
 		
 		// -- Step 2. Using the closest arc segment and the two surrounding points, do a binary search to find progressively closer
 		//            points until the threshold is reached.
@@ -155,17 +342,17 @@ namespace Curve
 		
 		if(closest_arc_index > 0)
 		{
-			CurveArc@ c1 = v.arcs[closest_arc_index - 1];
-			t1 = si1 + c1.t;
-			p1x = c1.x;
-			p1y = c1.y;
+			const int c1 = v.arc_offset + closest_arc_index - 1;
+			t1 = si1 + arc_t[c1];
+			p1x = arc_x[c1];
+			p1y = arc_y[c1];
 		}
 		else if(segment_index > 0)
 		{
-			CurveArc@ c1 = vertices[segment_index - 1].arc_from_end(1);
-			t1 = si1 + c1.t;
-			p1x = c1.x;
-			p1y = c1.y;
+			const int c1 = vertices[segment_index - 1].arc_from_end(1);
+			t1 = si1 + arc_t[c1];
+			p1x = arc_x[c1];
+			p1y = arc_y[c1];
 		}
 		else
 		{
@@ -176,24 +363,24 @@ namespace Curve
 		
 		if(is_interpolated)
 		{
-			CurveArc@ c2 = v.arcs[closest_arc_index];
-			t2 = si2 + c2.t;
-			p2x = c2.x;
-			p2y = c2.y;
+			const int c2 = v.arc_offset + closest_arc_index;
+			t2 = si2 + arc_t[c2];
+			p2x = arc_x[c2];
+			p2y = arc_y[c2];
 		}
 		else if(closest_arc_index < v.arc_count - 1)
 		{
-			CurveArc@ c2 = v.arcs[closest_arc_index + 1];
-			t2 = si2 + c2.t;
-			p2x = c2.x;
-			p2y = c2.y;
+			const int c2 = v.arc_offset + closest_arc_index + 1;
+			t2 = si2 + arc_t[c2];
+			p2x = arc_x[c2];
+			p2y = arc_y[c2];
 		}
 		else if(closed || segment_index < end - 1)
 		{
-			CurveArc@ c2 = vertices[(segment_index + 1) % vertex_count].arc_from_start(1);
-			t2 = si2 + c2.t;
-			p2x = c2.x;
-			p2y = c2.y;
+			const int c2 = vertices[(segment_index + 1) % vertex_count].arc_from_start(1);
+			t2 = si2 + arc_t[c2];
+			p2x = arc_x[c2];
+			p2y = arc_y[c2];
 		}
 		else
 		{
@@ -204,6 +391,80 @@ namespace Curve
 		
 		threshold *= threshold;
 		
+		if(newton)
+		{
+			float lo = t1;
+			float hi = t2;
+			float nt = out_t;
+			bool supported = true;
+			
+			for(int n = 0; n < 16; n++)
+			{
+				float nx, ny, ndx, ndy, nddx, nddy;
+				const int ni = (int(nt) % vertex_count + vertex_count) % vertex_count;
+				if(!kernel.eval_derivatives(ni, fraction(nt), nx, ny, ndx, ndy, nddx, nddy))
+				{
+					supported = false;
+					break;
+				}
+				
+				iterations++;
+				evals++;
+				
+				const float ex = nx - x;
+				const float ey = ny - y;
+				const float n_dist = ex * ex + ey * ey;
+				if(n_dist < dist)
+				{
+					out_t = nt;
+					out_x = nx;
+					out_y = ny;
+					dist = n_dist;
+				}
+				
+				// Half the derivative of the squared distance. If positive the distance is increasing, so the minimum is before `nt`.
+				const float f = ex * ndx + ey * ndy;
+				if(f > 0)
+				{
+					hi = nt;
+				}
+				else
+				{
+					lo = nt;
+				}
+				
+				// Bisect the bounds instead if the step would leave them, or head towards a maximum.
+				const float fd = ndx * ndx + ndy * ndy + ex * nddx + ey * nddy;
+				float next_t = fd > 0 ? nt - f / fd : lo - 1;
+				if(next_t <= lo || next_t >= hi)
+				{
+					next_t = (lo + hi) * 0.5;
+				}
+				
+				// Stop once the next step would move the point less than the threshold.
+				const float step = next_t - nt;
+				nt = next_t;
+				if(step * step * (ndx * ndx + ndy * ndy) <= threshold || closeTo(lo, hi))
+					break;
+			}
+			
+			if(supported)
+			{
+				if(!closed && out_t >= end)
+				{
+					segment_index = end - 1;
+					out_t = 1;
+				}
+				else
+				{
+					segment_index = (int(out_t) % vertex_count + vertex_count) % vertex_count;
+					out_t = fraction(out_t);
+				}
+				
+				return max_distance <= 0 || dist <= max_distance * max_distance;
+			}
+		}
+		
 		// Interpolating the initial guess usually makes it more acurate.
 		// Making the bounds tighter initially and slowly increasing back to 0.5 seems to save on iterations and reach the threshold somewhat faster.
 		float binary_search_factor;
@@ -227,15 +488,18 @@ namespace Curve
 			// Left side.
 			const float t1m = out_t + (t1 - out_t) * binary_search_factor;
 			const int i1 = (int(t1m) % vertex_count + vertex_count) % vertex_count;
-			eval_point(i1, fraction(t1m), p1mx, p1my);
+			kernel.eval_point(i1, fraction(t1m), p1mx, p1my);
 			const float dist1m = (p1mx - x) * (p1mx - x) + (p1my - y) * (p1my - y);
 			
 			// Right side.
 			const float t2m = out_t + (t2 - out_t) * binary_search_factor;
 			const int i2 = (int(t2m) % vertex_count + vertex_count) % vertex_count;
-			eval_point(i2, fraction(t2m), p2mx, p2my);
+			kernel.eval_point(i2, fraction(t2m), p2mx, p2my);
 			const float dist2m = (p2mx - x) * (p2mx - x) + (p2my - y) * (p2my - y);
 			
+			iterations++;
+			evals += 2;
+			
 			// Mid point is closest.
 			if(dist <= dist1m && dist <= dist2m)
 			{
@@ -291,7 +555,8 @@ namespace Curve
 				out_t = t1 + (t2 - t1) * it;
 				segment_index = (int(out_t) % vertex_count + vertex_count) % vertex_count;
 				out_t = fraction(out_t);
-				eval_point(segment_index, out_t, out_x, out_y);
+				kernel.eval_point(segment_index, out_t, out_x, out_y);
+				evals++;
 			}
 		}
 		else
@@ -305,4 +570,54 @@ namespace Curve
 		return true;
 	}
 	
+	/** Internal method - moves the entry at `i` down the min heap until neither of its children are smaller. */
+	void _heap_sift_down(array<float>@ heap_dist, array<int>@ heap_segment, const int size, int i)
+	{
+		const float dist = heap_dist[i];
+		const int segment = heap_segment[i];
+		
+		while(true)
+		{
+			int child = i * 2 + 1;
+			if(child >= size)
+				break;
+			if(child + 1 < size && heap_dist[child + 1] < heap_dist[child])
+			{
+				child++;
+			}
+			if(heap_dist[child] >= dist)
+				break;
+			
+			heap_dist[i] = heap_dist[child];
+			heap_segment[i] = heap_segment[child];
+			i = child;
+		}
+		
+		heap_dist[i] = dist;
+		heap_segment[i] = segment;
+	}
+	
+	/** Same as the `CurveKernel` version, but evaluates the curve through an `EvalPointFunc` delegate. */
+	bool closest_point(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
+		CurveArcs@ arcs,
+		EvalPointFunc@ eval_point,
+		const float x, const float y, int &out segment_index, float &out out_t, float &out out_x, float &out out_y,
+		const float max_distance=0, float threshold=1,
+		const bool arc_length_interpolation=true,
+		const bool adjust_initial_binary_factor=true,
+		const bool interpolate_result=true,
+		const float x1=-INFINITY, const float y1=-INFINITY, const float x2=INFINITY, const float y2=INFINITY)
+	{
+		return closest_point(
+			vertices, vertex_count, closed, arcs,
+			CurveFuncKernel(null, eval_point, null),
+			x, y, segment_index, out_t, out_x, out_y,
+			max_distance, threshold,
+			arc_length_interpolation,
+			adjust_initial_binary_factor,
+			interpolate_result,
+			x1, y1, x2, y2);
+	}
+	
 }
@@ -0,0 +1,291 @@
+namespace Curve
+{
+	
+	/** Finds the closest point on the curve to each of the given points. Similar to calling `closest_point` for each point, but much faster
+	  * for many points. The candidate segments of every point are found with the segment bounding volume hierarchy and
+	  * grouped by segment, so that the arcs of each segment are only read once for all of the points near it, and each point is then refined
+	  * individually.
+	  * Arcs are compared using the distance to their chord instead of `arc_length_interpolation`, which avoids evaluating the curve for every
+	  * nearby arc. See `closest_point` for the other parameters.
+	  * @param bvh The bounding volume hierarchy of the segments. Must have been updated with the same vertices.
+	  * @param xs ys The points to find the closest points to.
+	  * @param count The number of points.
+	  * @param out_segments Receives the segment index of each closest point, or -1 if none was found within `max_distance`.
+	  * @param out_ts out_xs out_ys Receive the t value and position of each closest point.
+	  *   All of the output arrays are resized if needed.
+	  * @param stats If set, the number of iterations and curve evaluations for all points are added to it.
+	  * @param scratch Scratch arrays, so that they don't need to be allocated for every call.
+	  * @return The number of points that a closest point was found for. */
+	int closest_points(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
+		CurveArcs@ arcs,
+		CurveKernel@ kernel,
+		CurveSegmentBVH@ bvh,
+		const array<float>@ xs, const array<float>@ ys, const int count,
+		array<int>@ out_segments, array<float>@ out_ts, array<float>@ out_xs, array<float>@ out_ys,
+		const float max_distance=0, const float threshold=1,
+		const bool adjust_initial_binary_factor=true,
+		const bool interpolate_result=true,
+		const bool newton=false,
+		CurveClosestPointStats@ stats=null,
+		CurveClosestPointsScratch@ scratch=null)
+	{
+		if(int(out_segments.length) < count) out_segments.resize(count);
+		if(int(out_ts.length) < count) out_ts.resize(count);
+		if(int(out_xs.length) < count) out_xs.resize(count);
+		if(int(out_ys.length) < count) out_ys.resize(count);
+		
+		for(int q = 0; q < count; q++)
+		{
+			out_segments[q] = -1;
+		}
+		
+		if(vertex_count == 0 || arcs.size == 0 || count <= 0)
+			return 0;
+		
+		const int end = closed ? vertex_count : vertex_count - 1;
+		
+		if(scratch is null)
+		{
+			@scratch = CurveClosestPointsScratch();
+		}
+		scratch.reserve(count, end);
+		
+		const float max_distance_sqr = max_distance > 0 ? max_distance * max_distance : INFINITY;
+		
+		const array<float>@ arc_t = @arcs.t;
+		const array<float>@ arc_x = @arcs.x;
+		const array<float>@ arc_y = @arcs.y;
+		const array<float>@ arc_dx = @arcs.dx;
+		const array<float>@ arc_dy = @arcs.dy;
+		const array<float>@ arc_length = @arcs.length;
+		const array<float>@ arc_length_sqr = @arcs.length_sqr;
+		
+		// -- Step 1. Find the segments that could contain the closest point for each point.
+		
+		array<int>@ pair_segment = @scratch.pair_segment;
+		array<int>@ pair_query = @scratch.pair_query;
+		int pair_count = 0;
+		
+		for(int q = 0; q < count; q++)
+		{
+			const float x = xs[q];
+			const float y = ys[q];
+			float bound = max_distance_sqr;
+			bool first = true;
+			int segment;
+			float box_dist;
+			
+			bvh.nearest_start(x, y);
+			while(bvh.nearest_next(segment, box_dist) && box_dist <= bound)
+			{
+				// The ends and middle of the nearest segment are on the curve, so no closer segment can be farther away than them.
+				if(first && vertices[segment].arc_count > 0)
+				{
+					CurveVertex@ v = vertices[segment];
+					for(int i = 0; i < 3; i++)
+					{
+						const int k = v.arc_offset + (v.arc_count - 1) * i / 2;
+						bound = min(bound, (arc_x[k] - x) * (arc_x[k] - x) + (arc_y[k] - y) * (arc_y[k] - y));
+					}
+					first = false;
+				}
+				
+				if(pair_count >= int(pair_segment.length))
+				{
+					pair_segment.resize(pair_count * 2);
+					pair_query.resize(pair_count * 2);
+				}
+				
+				pair_segment[pair_count] = segment;
+				pair_query[pair_count] = q;
+				pair_count++;
+			}
+		}
+		
+		// -- Step 2. Group the points by segment, so that the points of segment `i` are `bucket_start[i]` to `bucket_start[i + 1]`.
+		
+		array<int>@ bucket_start = @scratch.bucket_start;
+		array<int>@ bucket_query = @scratch.bucket_query;
+		if(int(bucket_query.length) < pair_count)
+		{
+			bucket_query.resize(pair_count);
+		}
+		
+		for(int i = 0; i <= end; i++)
+		{
+			bucket_start[i] = 0;
+		}
+		for(int p = 0; p < pair_count; p++)
+		{
+			bucket_start[pair_segment[p] + 1]++;
+		}
+		for(int i = 1; i <= end; i++)
+		{
+			bucket_start[i] += bucket_start[i - 1];
+		}
+		
+		// Filling each bucket moves its start to the start of the next one, so shift them back afterwards.
+		for(int p = 0; p < pair_count; p++)
+		{
+			const int i = pair_segment[p];
+			bucket_query[bucket_start[i]] = pair_query[p];
+			bucket_start[i]++;
+		}
+		for(int i = end; i > 0; i--)
+		{
+			bucket_start[i] = bucket_start[i - 1];
+		}
+		bucket_start[0] = 0;
+		
+		// -- Step 3. Scan the arcs of each segment once against all of its points.
+		
+		array<float>@ best_dist = @scratch.best_dist;
+		array<int>@ best_segment = @scratch.best_segment;
+		array<int>@ best_arc = @scratch.best_arc;
+		array<bool>@ best_exact = @scratch.best_exact;
+		array<float>@ best_t = @scratch.best_t;
+		array<float>@ best_x = @scratch.best_x;
+		array<float>@ best_y = @scratch.best_y;
+		
+		for(int q = 0; q < count; q++)
+		{
+			best_dist[q] = INFINITY;
+			best_segment[q] = -1;
+		}
+		
+		for(int i = 0; i < end; i++)
+		{
+			const int b1 = bucket_start[i];
+			const int b2 = bucket_start[i + 1];
+			if(b1 == b2)
+				continue;
+			
+			// Segments with a closed form solution don't need their arcs to be tested.
+			bool exact = true;
+			for(int b = b1; b < b2; b++)
+			{
+				const int q = bucket_query[b];
+				float e_t, e_x, e_y;
+				exact = kernel.closest_point(i, xs[q], ys[q], e_t, e_x, e_y);
+				if(!exact)
+					break;
+				
+				const float e_dist = (xs[q] - e_x) * (xs[q] - e_x) + (ys[q] - e_y) * (ys[q] - e_y);
+				if(e_dist < best_dist[q])
+				{
+					best_dist[q] = e_dist;
+					best_segment[q] = i;
+					best_exact[q] = true;
+					best_t[q] = e_t;
+					best_x[q] = e_x;
+					best_y[q] = e_y;
+				}
+			}
+			
+			if(exact)
+				continue;
+			
+			CurveVertex@ v = vertices[i];
+			const int o = v.arc_offset;
+			
+			// The first arc is the start of the segment, so is already covered by the chord of the second, unless it's the only one.
+			for(int j = v.arc_count > 1 ? 1 : 0; j < v.arc_count; j++)
+			{
+				const int k = o + j;
+				const float c0x = j > 0 ? arc_x[k - 1] : arc_x[k];
+				const float c0y = j > 0 ? arc_y[k - 1] : arc_y[k];
+				const float c_dx = j > 0 ? arc_dx[k] : 0.0;
+				const float c_dy = j > 0 ? arc_dy[k] : 0.0;
+				const float c_length_sqr = j > 0 ? arc_length_sqr[k] : 0.0;
+				
+				for(int b = b1; b < b2; b++)
+				{
+					const int q = bucket_query[b];
+					const float x = xs[q];
+					const float y = ys[q];
+					
+					const float lt = c_length_sqr != 0 ? clamp01(((x - c0x) * c_dx + (y - c0y) * c_dy) / c_length_sqr) : 0.0;
+					const float lx = c0x + c_dx * lt;
+					const float ly = c0y + c_dy * lt;
+					const float c_dist = (x - lx) * (x - lx) + (y - ly) * (y - ly);
+					
+					if(c_dist >= best_dist[q])
+						continue;
+					
+					best_dist[q] = c_dist;
+					best_segment[q] = i;
+					best_exact[q] = false;
+					// Start the refinement from whichever end of the chord is closer.
+					best_arc[q] = j > 0 && lt < 0.5 ? j - 1 : j;
+				}
+			}
+		}
+		
+		// -- Step 4. Refine each point.
+		
+		int found = 0;
+		int iterations = 0;
+		int evals = 0;
+		
+		for(int q = 0; q < count; q++)
+		{
+			const int i = best_segment[q];
+			if(i == -1)
+				continue;
+			
+			if(best_exact[q])
+			{
+				if(best_dist[q] > max_distance_sqr)
+					continue;
+				
+				out_segments[q] = i;
+				out_ts[q] = best_t[q];
+				out_xs[q] = best_x[q];
+				out_ys[q] = best_y[q];
+				found++;
+				continue;
+			}
+			
+			const float x = xs[q];
+			const float y = ys[q];
+			const int k = vertices[i].arc_offset + best_arc[q];
+			const float px = arc_x[k];
+			const float py = arc_y[k];
+			
+			int segment;
+			float t, rx, ry;
+			int refine_iterations, refine_evals;
+			const bool result = _closest_point_refine(
+				vertices, vertex_count, closed, arcs, kernel, x, y,
+				i, best_arc[q], arc_length[k], false, -1,
+				arc_t[k], px, py, (x - px) * (x - px) + (y - py) * (y - py),
+				max_distance, threshold,
+				false,
+				adjust_initial_binary_factor,
+				interpolate_result,
+				newton,
+				segment, t, rx, ry, refine_iterations, refine_evals);
+			
+			iterations += refine_iterations;
+			evals += refine_evals;
+			
+			if(!result)
+				continue;
+			
+			out_segments[q] = segment;
+			out_ts[q] = t;
+			out_xs[q] = rx;
+			out_ys[q] = ry;
+			found++;
+		}
+		
+		if(stats !is null)
+		{
+			stats.add(iterations, evals);
+		}
+		
+		return found;
+	}
+	
+}
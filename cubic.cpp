@@ -89,4 +89,77 @@ namespace CubicBezier
 		}
 	}
 	
+	/** Calculate the first derivative at the given t value for a non-rational cubic bezier curve defined by
+	  * two vertices (`p1` and `p4`) and two control point (`p2` and `p3`). */
+	void eval_derivative(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y,
+		const float t, float &out dx, float &out dy)
+	{
+		const float u = 1 - t;
+		const float uu3 = 3*u*u;
+		const float ut6 = 6*u*t;
+		const float tt3 = 3*t*t;
+		
+		dx = uu3*(p2x - p1x) + ut6*(p3x - p2x) + tt3*(p4x - p3x);
+		dy = uu3*(p2y - p1y) + ut6*(p3y - p2y) + tt3*(p4y - p3y);
+	}
+	
+	/** Calculate the position and normal at each t value in `ts` between `start` and `end` (exclusive) for a non-rational cubic
+	  * bezier curve. The coefficients are calculated once, so this is much faster than calling `eval` for each t value.
+	  * The results for `ts[i]` are written to `out_xy[i * 2]`/`out_xy[i * 2 + 1]` and `out_normals[i * 2]`/`out_normals[i * 2 + 1]`. */
+	void eval_many(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y,
+		array<float>@ ts, const int start, const int end, array<float>@ out_xy, array<float>@ out_normals)
+	{
+		const float bx = 3 * (p2x - p1x);
+		const float by = 3 * (p2y - p1y);
+		const float cx = 3 * (p1x - 2 * p2x + p3x);
+		const float cy = 3 * (p1y - 2 * p2y + p3y);
+		const float dx = -p1x + 3 * (p2x - p3x) + p4x;
+		const float dy = -p1y + 3 * (p2y - p3y) + p4y;
+		
+		for(int i = start; i < end; i++)
+		{
+			const float t = ts[i];
+			out_xy[i * 2] = ((dx * t + cx) * t + bx) * t + p1x;
+			out_xy[i * 2 + 1] = ((dy * t + cy) * t + by) * t + p1y;
+			
+			float normal_x = (3 * dy * t + 2 * cy) * t + by;
+			float normal_y = -((3 * dx * t + 2 * cx) * t + bx);
+			
+			const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+			if(length != 0)
+			{
+				normal_x /= length;
+				normal_y /= length;
+			}
+			
+			out_normals[i * 2] = normal_x;
+			out_normals[i * 2 + 1] = normal_y;
+		}
+	}
+	
+	/** Same as `eval_many` but only calculates the positions. */
+	void eval_many_point(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y,
+		array<float>@ ts, const int start, const int end, array<float>@ out_xy)
+	{
+		const float bx = 3 * (p2x - p1x);
+		const float by = 3 * (p2y - p1y);
+		const float cx = 3 * (p1x - 2 * p2x + p3x);
+		const float cy = 3 * (p1y - 2 * p2y + p3y);
+		const float dx = -p1x + 3 * (p2x - p3x) + p4x;
+		const float dy = -p1y + 3 * (p2y - p3y) + p4y;
+		
+		for(int i = start; i < end; i++)
+		{
+			const float t = ts[i];
+			out_xy[i * 2] = ((dx * t + cx) * t + bx) * t + p1x;
+			out_xy[i * 2 + 1] = ((dy * t + cy) * t + by) * t + p1y;
+		}
+	}
+	
 }
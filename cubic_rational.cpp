@@ -155,4 +155,108 @@ namespace CubicBezier
 		return uuu*r1 + 3*uu*t*r2 + 3*u*tt*r3 + tt3 * r4;
 	}
 	
+	/** Calculate the first derivative at the given t value for a rational cubic bezier curve defined by
+	  * two vertices (`p1` and `p4`) and two control point (`p2` and `p3`), and the corresponding ratios/weights. */
+	void eval_derivative(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y,
+		const float r1, const float r2, const float r3, const float r4,
+		const float t, float &out dx, float &out dy)
+	{
+		const float u = 1 - t;
+		const float tt = t*t;
+		const float uu = u*u;
+		
+		const float f1 = uu*u*r1;
+		const float f2 = 3*uu*t*r2;
+		const float f3 = 3*u*tt*r3;
+		const float f4 = tt*t*r4;
+		const float basis = f1 + f2 + f3 + f4;
+		
+		const float uu3 = 3*uu;
+		const float ut6 = 6*u*t;
+		const float tt3 = 3*tt;
+		const float basis_d = uu3*(r2 - r1) + ut6*(r3 - r2) + tt3*(r4 - r3);
+		
+		const float x = (f1*p1x + f2*p2x + f3*p3x + f4*p4x) / basis;
+		const float y = (f1*p1y + f2*p2y + f3*p3y + f4*p4y) / basis;
+		
+		dx = (uu3*(r2*p2x - r1*p1x) + ut6*(r3*p3x - r2*p2x) + tt3*(r4*p4x - r3*p3x) - basis_d*x) / basis;
+		dy = (uu3*(r2*p2y - r1*p1y) + ut6*(r3*p3y - r2*p2y) + tt3*(r4*p4y - r3*p3y) - basis_d*y) / basis;
+	}
+	
+	/** Calculate the position and normal at each t value in `ts` between `start` and `end` (exclusive) for a rational cubic
+	  * bezier curve. See the non-rational `eval_many`. */
+	void eval_many(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y,
+		const float r1, const float r2, const float r3, const float r4,
+		array<float>@ ts, const int start, const int end, array<float>@ out_xy, array<float>@ out_normals)
+	{
+		// Power basis coefficients of the weighted points and the weights.
+		const float ax = p1x * r1;
+		const float ay = p1y * r1;
+		const float bx = 3 * (p2x * r2 - ax);
+		const float by = 3 * (p2y * r2 - ay);
+		const float cx = 3 * (ax - 2 * p2x * r2 + p3x * r3);
+		const float cy = 3 * (ay - 2 * p2y * r2 + p3y * r3);
+		const float dx = -ax + 3 * (p2x * r2 - p3x * r3) + p4x * r4;
+		const float dy = -ay + 3 * (p2y * r2 - p3y * r3) + p4y * r4;
+		const float bw = 3 * (r2 - r1);
+		const float cw = 3 * (r1 - 2 * r2 + r3);
+		const float dw = -r1 + 3 * (r2 - r3) + r4;
+		
+		for(int i = start; i < end; i++)
+		{
+			const float t = ts[i];
+			const float w = ((dw * t + cw) * t + bw) * t + r1;
+			const float dw_dt = (3 * dw * t + 2 * cw) * t + bw;
+			const float x = (((dx * t + cx) * t + bx) * t + ax) / w;
+			const float y = (((dy * t + cy) * t + by) * t + ay) / w;
+			out_xy[i * 2] = x;
+			out_xy[i * 2 + 1] = y;
+			
+			float normal_x = ((3 * dy * t + 2 * cy) * t + by - y * dw_dt) / w;
+			float normal_y = -((3 * dx * t + 2 * cx) * t + bx - x * dw_dt) / w;
+			
+			const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+			if(length != 0)
+			{
+				normal_x /= length;
+				normal_y /= length;
+			}
+			
+			out_normals[i * 2] = normal_x;
+			out_normals[i * 2 + 1] = normal_y;
+		}
+	}
+	
+	/** Same as `eval_many` but only calculates the positions. */
+	void eval_many_point(
+		const float p1x, const float p1y, const float p2x, const float p2y,
+		const float p3x, const float p3y, const float p4x, const float p4y,
+		const float r1, const float r2, const float r3, const float r4,
+		array<float>@ ts, const int start, const int end, array<float>@ out_xy)
+	{
+		const float ax = p1x * r1;
+		const float ay = p1y * r1;
+		const float bx = 3 * (p2x * r2 - ax);
+		const float by = 3 * (p2y * r2 - ay);
+		const float cx = 3 * (ax - 2 * p2x * r2 + p3x * r3);
+		const float cy = 3 * (ay - 2 * p2y * r2 + p3y * r3);
+		const float dx = -ax + 3 * (p2x * r2 - p3x * r3) + p4x * r4;
+		const float dy = -ay + 3 * (p2y * r2 - p3y * r3) + p4y * r4;
+		const float bw = 3 * (r2 - r1);
+		const float cw = 3 * (r1 - 2 * r2 + r3);
+		const float dw = -r1 + 3 * (r2 - r3) + r4;
+		
+		for(int i = start; i < end; i++)
+		{
+			const float t = ts[i];
+			const float w = ((dw * t + cw) * t + bw) * t + r1;
+			out_xy[i * 2] = (((dx * t + cx) * t + bx) * t + ax) / w;
+			out_xy[i * 2 + 1] = (((dy * t + cy) * t + by) * t + ay) / w;
+		}
+	}
+	
 }
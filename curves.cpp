@@ -17,6 +17,7 @@ class script : MultiCurveDebugColourCallback
 	[persist] bool arc_length_interpolation = true;
 	[persist] bool adaptive_stretch_factor = true;
 	[persist] bool adjust_initial_binary_factor = true;
+	[persist] bool newton_refinement = false;
 	[persist] bool render_arc_lengths = false;
 	[persist] bool render_segment_bboxes = true;
 	[persist] float max_mouse_distance = 0;
@@ -56,6 +57,7 @@ class script : MultiCurveDebugColourCallback
 	int drag_control_point_index;
 	float drag_ox, drag_oy;
 	ClosestPointTest closest_point;
+	CurveClosestPoint closest_point_state;
 	bool drag_force_mirror;
 	
 	MultiCurve curve;
@@ -675,9 +677,10 @@ class script : MultiCurveDebugColourCallback
 	
 	void find_closest_point()
 	{
-		closest_point.found = curve.closest_point(
+		closest_point.found = curve.closest_point_warm(
+			closest_point_state,
 			mouse.x, mouse.y, closest_point.i, closest_point.t, closest_point.x, closest_point.y,
-			max_mouse_distance * zoom_factor, 1, arc_length_interpolation, adjust_initial_binary_factor, true);
+			max_mouse_distance * zoom_factor, 1, arc_length_interpolation, adjust_initial_binary_factor, true, newton_refinement);
 		
 		if(closest_point.found)
 		{
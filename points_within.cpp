@@ -0,0 +1,155 @@
+namespace Curve
+{
+	
+	/** Finds every point on the curve within `radius` of `x`, `y` that is closer than the points around it, e.g. each place a circle touches
+	  * or crosses a curve that loops back on itself. The arc points that are closer than both of their neighbours are each refined the same
+	  * way as `closest_point`. See `closest_point` for the other parameters.
+	  * @param out_points Receives the points in order along the curve. Resized if needed.
+	  * @param candidates If set, only these segments are tested, e.g. the segments found by `CurveSegmentBVH.query_rect`.
+	  *   Must be in ascending order.
+	  * @param candidate_count The number of segments in `candidates`.
+	  * @param stats If set, the number of iterations and curve evaluations for all points are added to it.
+	  * @return The number of points found. */
+	int points_within(
+		array<CurveVertex>@ vertices, const int vertex_count, const bool closed,
+		CurveArcs@ arcs,
+		CurveKernel@ kernel,
+		const float x, const float y, const float radius,
+		array<CurveSegmentPoint>@ out_points,
+		const array<int>@ candidates=null, const int candidate_count=0,
+		const float threshold=1,
+		const bool adjust_initial_binary_factor=true,
+		const bool interpolate_result=true,
+		const bool newton=false,
+		CurveClosestPointStats@ stats=null)
+	{
+		if(vertex_count == 0 || arcs.size == 0 || radius <= 0)
+			return 0;
+		
+		const int end = closed ? vertex_count : vertex_count - 1;
+		const float radius_sqr = radius * radius;
+		const float threshold_sqr = threshold * threshold;
+		const int segment_count = candidates !is null ? candidate_count : end;
+		
+		const array<float>@ arc_t = @arcs.t;
+		const array<float>@ arc_x = @arcs.x;
+		const array<float>@ arc_y = @arcs.y;
+		const array<float>@ arc_length = @arcs.length;
+		
+		int count = 0;
+		int iterations = 0;
+		int evals = 0;
+		
+		for(int si = 0; si < segment_count; si++)
+		{
+			const int i = candidates !is null ? candidates[si] : si;
+			CurveVertex@ v = vertices[i];
+			
+			if(x < v.x1 - radius || x > v.x2 + radius || y < v.y1 - radius || y > v.y2 + radius)
+				continue;
+			
+			const bool has_prev = i > 0 || closed;
+			const bool has_next = i < end - 1 || closed;
+			const int o = v.arc_offset;
+			
+			// Start at 1 when there is a previous segment, since its last point is the same as the first point of this one.
+			for(int j = has_prev ? 1 : 0; j < v.arc_count; j++)
+			{
+				const int k = o + j;
+				const int k_prev = j > 0 ? k - 1 : -1;
+				const int k_next = j < v.arc_count - 1 ? k + 1
+					: has_next ? vertices[(i + 1) % vertex_count].arc_from_start(1)
+					: -1;
+				
+				const float dist = (arc_x[k] - x) * (arc_x[k] - x) + (arc_y[k] - y) * (arc_y[k] - y);
+				
+				// Only refine points that are closer than both neighbours. The ends of open curves only need to be closer than one.
+				if(k_prev != -1 && dist >= (arc_x[k_prev] - x) * (arc_x[k_prev] - x) + (arc_y[k_prev] - y) * (arc_y[k_prev] - y))
+					continue;
+				if(k_next != -1 && dist > (arc_x[k_next] - x) * (arc_x[k_next] - x) + (arc_y[k_next] - y) * (arc_y[k_next] - y))
+					continue;
+				
+				// The point could still be out of range while the curve either side of it dips inside.
+				if(dist > radius_sqr &&
+					_chord_distance_sqr(arc_x, arc_y, k_prev, k, x, y) > radius_sqr &&
+					_chord_distance_sqr(arc_x, arc_y, k, k_next, x, y) > radius_sqr)
+					continue;
+				
+				int segment;
+				float t, px, py;
+				int refine_iterations, refine_evals;
+				const bool found = _closest_point_refine(
+					vertices, vertex_count, closed, arcs, kernel, x, y,
+					i, j, arc_length[k], false, -1,
+					arc_t[k], arc_x[k], arc_y[k], dist,
+					radius, threshold,
+					false,
+					adjust_initial_binary_factor,
+					interpolate_result,
+					newton,
+					segment, t, px, py, refine_iterations, refine_evals);
+				
+				iterations += refine_iterations;
+				evals += refine_evals;
+				
+				if(!found)
+					continue;
+				
+				// Neighbouring points, e.g. either side of a flat section, can be refined to the same point.
+				if(count > 0)
+				{
+					CurveSegmentPoint@ last = out_points[count - 1];
+					if((last.x - px) * (last.x - px) + (last.y - py) * (last.y - py) <= threshold_sqr)
+						continue;
+				}
+				
+				if(count >= int(out_points.length))
+				{
+					out_points.resize(max(count * 2, 4));
+				}
+				
+				CurveSegmentPoint@ p = out_points[count++];
+				p.segment = segment;
+				p.t = t;
+				p.x = px;
+				p.y = py;
+			}
+		}
+		
+		// The last and first points of closed curves are also neighbours.
+		if(closed && count > 1)
+		{
+			CurveSegmentPoint@ first = out_points[0];
+			CurveSegmentPoint@ last = out_points[count - 1];
+			if((last.x - first.x) * (last.x - first.x) + (last.y - first.y) * (last.y - first.y) <= threshold_sqr)
+			{
+				count--;
+			}
+		}
+		
+		if(stats !is null)
+		{
+			stats.add(iterations, evals);
+		}
+		
+		return count;
+	}
+	
+	/** Internal method - returns the squared distance from the point to the chord between two arcs, or infinity if either arc index is -1. */
+	float _chord_distance_sqr(
+		const array<float>@ arc_x, const array<float>@ arc_y, const int k1, const int k2,
+		const float x, const float y)
+	{
+		if(k1 == -1 || k2 == -1)
+			return INFINITY;
+		
+		const float dx = arc_x[k2] - arc_x[k1];
+		const float dy = arc_y[k2] - arc_y[k1];
+		const float length_sqr = dx * dx + dy * dy;
+		const float t = length_sqr != 0 ? clamp01(((x - arc_x[k1]) * dx + (y - arc_y[k1]) * dy) / length_sqr) : 0.0;
+		const float cx = arc_x[k1] + dx * t - x;
+		const float cy = arc_y[k1] + dy * t - y;
+		return cx * cx + cy * cy;
+	}
+	
+}
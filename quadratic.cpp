@@ -63,4 +63,67 @@ namespace QuadraticBezier
 		}
 	}
 	
+	/** Calculate the first derivative at the given t value for a non-rational quadratic bezier curve defined by
+	  * two vertices (`p1` and `p3`) and a control point (`p2`). */
+	void eval_derivative(
+		const float p1x, const float p1y, const float p2x, const float p2y, const float p3x, const float p3y,
+		const float t, float &out dx, float &out dy)
+	{
+		const float u = 1 - t;
+		
+		dx = 2*(u*(p2x - p1x) + t*(p3x - p2x));
+		dy = 2*(u*(p2y - p1y) + t*(p3y - p2y));
+	}
+	
+	/** Calculate the position and normal at each t value in `ts` between `start` and `end` (exclusive) for a non-rational quadratic
+	  * bezier curve. The coefficients are calculated once, so this is much faster than calling `eval` for each t value.
+	  * The results for `ts[i]` are written to `out_xy[i * 2]`/`out_xy[i * 2 + 1]` and `out_normals[i * 2]`/`out_normals[i * 2 + 1]`. */
+	void eval_many(
+		const float p1x, const float p1y, const float p2x, const float p2y, const float p3x, const float p3y,
+		array<float>@ ts, const int start, const int end, array<float>@ out_xy, array<float>@ out_normals)
+	{
+		const float bx = 2 * (p2x - p1x);
+		const float by = 2 * (p2y - p1y);
+		const float cx = p1x - 2 * p2x + p3x;
+		const float cy = p1y - 2 * p2y + p3y;
+		
+		for(int i = start; i < end; i++)
+		{
+			const float t = ts[i];
+			out_xy[i * 2] = (cx * t + bx) * t + p1x;
+			out_xy[i * 2 + 1] = (cy * t + by) * t + p1y;
+			
+			float normal_x = 2 * cy * t + by;
+			float normal_y = -(2 * cx * t + bx);
+			
+			const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+			if(length != 0)
+			{
+				normal_x /= length;
+				normal_y /= length;
+			}
+			
+			out_normals[i * 2] = normal_x;
+			out_normals[i * 2 + 1] = normal_y;
+		}
+	}
+	
+	/** Same as `eval_many` but only calculates the positions. */
+	void eval_many_point(
+		const float p1x, const float p1y, const float p2x, const float p2y, const float p3x, const float p3y,
+		array<float>@ ts, const int start, const int end, array<float>@ out_xy)
+	{
+		const float bx = 2 * (p2x - p1x);
+		const float by = 2 * (p2y - p1y);
+		const float cx = p1x - 2 * p2x + p3x;
+		const float cy = p1y - 2 * p2y + p3y;
+		
+		for(int i = start; i < end; i++)
+		{
+			const float t = ts[i];
+			out_xy[i * 2] = (cx * t + bx) * t + p1x;
+			out_xy[i * 2 + 1] = (cy * t + by) * t + p1y;
+		}
+	}
+	
 }
@@ -0,0 +1,107 @@
+namespace QuadraticBezier
+{
+	
+	/** Calculate the exact closest point to `x`, `y` on a non-rational quadratic bezier curve defined by
+	  * two vertices (`p1` and `p3`) and a control point (`p2`).
+	  * The closest point is either an end point, or where `(B(t) - P) . B'(t)` is zero, which is a cubic in t. */
+	void closest_point(
+		const float p1x, const float p1y, const float p2x, const float p2y, const float p3x, const float p3y,
+		const float x, const float y,
+		float &out t, float &out px, float &out py)
+	{
+		// Power basis coefficients relative to the point, i.e. `B(t) - P = a + b*t + c*t^2`.
+		const float ax = p1x - x;
+		const float ay = p1y - y;
+		const float bx = 2*(p2x - p1x);
+		const float by = 2*(p2y - p1y);
+		const float cx = p1x - 2*p2x + p3x;
+		const float cy = p1y - 2*p2y + p3y;
+		
+		// Start with the closest end point.
+		const float d1 = ax*ax + ay*ay;
+		const float d3 = (p3x - x)*(p3x - x) + (p3y - y)*(p3y - y);
+		t = d1 <= d3 ? 0.0 : 1.0;
+		float dist = d1 <= d3 ? d1 : d3;
+		
+		const float k3 = 2*(cx*cx + cy*cy);
+		const float k2 = 3*(bx*cx + by*cy);
+		const float k1 = bx*bx + by*by + 2*(ax*cx + ay*cy);
+		const float k0 = ax*bx + ay*by;
+		
+		// Roots outside of 0-1 are ignored.
+		float r1 = -1, r2 = -1, r3 = -1;
+		int root_count = 0;
+		
+		if(k3 <= 0.000001 * (bx*bx + by*by))
+		{
+			// The control point is in line with the end points, so the curve is a straight line.
+			if(k1 != 0)
+			{
+				r1 = -k0/k1;
+				root_count = 1;
+			}
+		}
+		else
+		{
+			// Solve the normalised cubic `t^3 + e2*t^2 + e1*t + e0` with the trigonometric or Cardano's method.
+			const float e2 = k2/k3;
+			const float e1 = k1/k3;
+			const float e0 = k0/k3;
+			const float q = (3*e1 - e2*e2)/9;
+			const float r = (9*e2*e1 - 27*e0 - 2*e2*e2*e2)/54;
+			const float disc = q*q*q + r*r;
+			const float offset = -e2/3;
+			
+			if(disc > 0)
+			{
+				const float sd = sqrt(disc);
+				const float s = r + sd;
+				const float u = r - sd;
+				r1 = offset + (s < 0 ? -pow(-s, 1.0/3) : pow(s, 1.0/3)) + (u < 0 ? -pow(-u, 1.0/3) : pow(u, 1.0/3));
+				root_count = 1;
+			}
+			else
+			{
+				const float m = 2*sqrt(-q);
+				const float theta = q < 0 ? acos(clamp(r/sqrt(-q*q*q), -1.0, 1.0)) : 0.0;
+				r1 = offset + m*cos(theta/3);
+				r2 = offset + m*cos((theta + 2*PI)/3);
+				r3 = offset + m*cos((theta + 4*PI)/3);
+				root_count = 3;
+			}
+		}
+		
+		for(int i = 0; i < root_count; i++)
+		{
+			float rt = i == 0 ? r1 : i == 1 ? r2 : r3;
+			
+			// The normalised coefficients become very large when the curve is nearly straight, which can make the roots inaccurate,
+			// so polish them with a couple of Newton steps on the original cubic.
+			for(int n = 0; n < 2; n++)
+			{
+				const float f = ((k3*rt + k2)*rt + k1)*rt + k0;
+				const float fd = (3*k3*rt + 2*k2)*rt + k1;
+				if(fd == 0)
+					break;
+				
+				rt -= f/fd;
+			}
+			
+			if(rt <= 0 || rt >= 1)
+				continue;
+			
+			const float ex = (cx*rt + bx)*rt + ax;
+			const float ey = (cy*rt + by)*rt + ay;
+			const float d = ex*ex + ey*ey;
+			if(d < dist)
+			{
+				t = rt;
+				dist = d;
+			}
+		}
+		
+		px = (cx*t + bx)*t + p1x;
+		py = (cy*t + by)*t + p1y;
+	}
+	
+}
@@ -115,4 +115,95 @@ namespace QuadraticBezier
 		return r1*uu + r2*ut2 + r3*tt;
 	}
 	
+	/** Calculate the first derivative at the given t value for a rational quadratic bezier curve defined by
+	  * two vertices (`p1` and `p3`) and a control point (`p2`), and the corresponding ratios/weights. */
+	void eval_derivative(
+		const float p1x, const float p1y, const float p2x, const float p2y, const float p3x, const float p3y,
+		const float r1, const float r2, const float r3,
+		const float t, float &out dx, float &out dy)
+	{
+		const float u = 1 - t;
+		const float tt = t*t;
+		const float uu = u*u;
+		const float ut2 = 2*u*t;
+		
+		const float f1 = r1*uu;
+		const float f2 = r2*ut2;
+		const float f3 = r3*tt;
+		const float basis = f1 + f2 + f3;
+		const float basis_d = 2*(u*(r2 - r1) + t*(r3 - r2));
+		
+		const float x = (f1*p1x + f2*p2x + f3*p3x) / basis;
+		const float y = (f1*p1y + f2*p2y + f3*p3y) / basis;
+		
+		dx = (2*(u*(r2*p2x - r1*p1x) + t*(r3*p3x - r2*p2x)) - basis_d*x) / basis;
+		dy = (2*(u*(r2*p2y - r1*p1y) + t*(r3*p3y - r2*p2y)) - basis_d*y) / basis;
+	}
+	
+	/** Calculate the position and normal at each t value in `ts` between `start` and `end` (exclusive) for a rational quadratic
+	  * bezier curve. See the non-rational `eval_many`. */
+	void eval_many(
+		const float p1x, const float p1y, const float p2x, const float p2y, const float p3x, const float p3y,
+		const float r1, const float r2, const float r3,
+		array<float>@ ts, const int start, const int end, array<float>@ out_xy, array<float>@ out_normals)
+	{
+		// Power basis coefficients of the weighted points and the weights.
+		const float ax = p1x * r1;
+		const float ay = p1y * r1;
+		const float bx = 2 * (p2x * r2 - ax);
+		const float by = 2 * (p2y * r2 - ay);
+		const float cx = ax - 2 * p2x * r2 + p3x * r3;
+		const float cy = ay - 2 * p2y * r2 + p3y * r3;
+		const float bw = 2 * (r2 - r1);
+		const float cw = r1 - 2 * r2 + r3;
+		
+		for(int i = start; i < end; i++)
+		{
+			const float t = ts[i];
+			const float w = (cw * t + bw) * t + r1;
+			const float dw_dt = 2 * cw * t + bw;
+			const float x = ((cx * t + bx) * t + ax) / w;
+			const float y = ((cy * t + by) * t + ay) / w;
+			out_xy[i * 2] = x;
+			out_xy[i * 2 + 1] = y;
+			
+			float normal_x = (2 * cy * t + by - y * dw_dt) / w;
+			float normal_y = -(2 * cx * t + bx - x * dw_dt) / w;
+			
+			const float length = sqrt(normal_x * normal_x + normal_y * normal_y);
+			if(length != 0)
+			{
+				normal_x /= length;
+				normal_y /= length;
+			}
+			
+			out_normals[i * 2] = normal_x;
+			out_normals[i * 2 + 1] = normal_y;
+		}
+	}
+	
+	/** Same as `eval_many` but only calculates the positions. */
+	void eval_many_point(
+		const float p1x, const float p1y, const float p2x, const float p2y, const float p3x, const float p3y,
+		const float r1, const float r2, const float r3,
+		array<float>@ ts, const int start, const int end, array<float>@ out_xy)
+	{
+		const float ax = p1x * r1;
+		const float ay = p1y * r1;
+		const float bx = 2 * (p2x * r2 - ax);
+		const float by = 2 * (p2y * r2 - ay);
+		const float cx = ax - 2 * p2x * r2 + p3x * r3;
+		const float cy = ay - 2 * p2y * r2 + p3y * r3;
+		const float bw = 2 * (r2 - r1);
+		const float cw = r1 - 2 * r2 + r3;
+		
+		for(int i = start; i < end; i++)
+		{
+			const float t = ts[i];
+			const float w = (cw * t + bw) * t + r1;
+			out_xy[i * 2] = ((cx * t + bx) * t + ax) / w;
+			out_xy[i * 2 + 1] = ((cy * t + by) * t + ay) / w;
+		}
+	}
+	
 }